@@ -1,48 +1,169 @@
 #include <game-activity/native_app_glue/android_native_app_glue.h>
 #include "Game.h"
 #include "Time/Time.h"
+#include "Time/Latency.h"
 #include "AndroidOut.h"
 #include "ECS/Entity.h"
+#include "ECS/SceneSerializer.h"
 #include "FileSystem/FileSystem.h"
-
-
-static const char *c_PlayerTag = "Player";
-static const char *c_BallTag = "Ball";
+#include "Memory/FrameArena.h"
+#include "Memory/MemoryTracker.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+static const StringId c_PlayerTag{"Player"};
+static const StringId c_BallTag{"Ball"};
+static const StringId c_LatencyTag{"Latency"};
+static const StringId c_BrickTag{"Brick"};
+static const StringId c_ScoreTag{"Score"};
+static const StringId c_LivesTag{"Lives"};
+static const StringId c_MenuTag{"Menu"};
+static const StringId c_GameOverTag{"GameOver"};
+static const StringId c_RetryTag{"Retry"};
+static const StringId c_ExitTag{"Exit"};
 constexpr V2 c_BallVelocity = {0.25f, -1.5f};
+// Shows the input-to-display latency percentiles on the HUD
+constexpr bool c_ShowLatencyOverlay = false;
+// Missing the ball rewinds the level by this many ticks instead of restarting it and puts
+// the ball back on the paddle. 0 disables it, snapshots are then never captured
+constexpr u32 c_InstantRetryTicks = 0;
+
+// Counters written in front of the serialized level by saveState
+struct SavedCounters {
+    u32 Score;
+    u32 Lives;
+    u32 Level;
+};
 
 Game::~Game() {
-
+    if (m_CurrentScene) {
+        m_CurrentScene->dumpStats("Level");
+    }
+    m_HUD.dumpStats("HUD");
+    m_Systems.dumpStats();
+    Latency::dump();
+    MemoryTracker::dump();
+    GLState::dump();
 }
 
-void Game::startGame() {
+void Game::startGame(const std::vector<u8> &savedState) {
+    // Budgets we expect to fit on low memory devices, exceeding them asserts on debug builds
+    MemoryTracker::setBudget(MemoryTag::Scene, 4 * 1024 * 1024);
+    MemoryTracker::setBudget(MemoryTag::Fonts, 1024 * 1024);
+    MemoryTracker::setGpuBudget(MemoryTag::Textures, 32 * 1024 * 1024);
+    MemoryTracker::setGpuBudget(MemoryTag::Fonts, 4 * 1024 * 1024);
+    // Textures dropped by a level stay cached for the next one up to this size
+    m_Renderer.setTextureBudget(8 * 1024 * 1024);
+
     loadAssets();
     loadLevels();
     loadUI();
+    registerSystems();
+
+    if (savedState.empty() || !restoreState(savedState)) {
+        setCurrentScene(m_Levels[0]);
+    }
+}
 
-    m_CurrentScene = Scene::copy(m_Levels[0]);
+std::vector<u8> Game::saveState() const {
+    if (!m_CurrentScene) {
+        return {};
+    }
+
+    const SavedCounters counters{m_Score, m_Lives, m_CurrentLevel};
+    const std::vector<u8> scene = SceneSerializer::serialize(*m_CurrentScene);
+    std::vector<u8> state(sizeof(counters) + scene.size());
+    memcpy(state.data(), &counters, sizeof(counters));
+    memcpy(state.data() + sizeof(counters), scene.data(), scene.size());
+    return state;
+}
+
+bool Game::restoreState(const std::vector<u8> &state) {
+    SavedCounters counters{};
+    if (state.size() < sizeof(counters)) {
+        return false;
+    }
+    memcpy(&counters, state.data(), sizeof(counters));
+
+    auto scene = SceneSerializer::deserialize(state.data() + sizeof(counters), state.size() - sizeof(counters));
+    if (!scene || counters.Lives == 0 || counters.Lives > c_MaxLives || counters.Level >= m_Levels.size()) {
+        aout << "Discarding invalid saved state" << std::endl;
+        return false;
+    }
+
+    setCurrentScene(std::move(scene));
+    m_Score = counters.Score;
+    m_Lives = counters.Lives;
+    m_CurrentLevel = counters.Level;
+    // The ball waits on the paddle for a touch
+    m_GameState = GameState::START;
+    return true;
 }
 
 void Game::update() {
     Time::startTimeUpdate();
 
-    handleGameLogic();
-    // Physics substepping
-    for (u32 i = 0; i < 4; i++) {
-        handlePhysics(Time::getDeltaTime() / 4);
+    handleMenu();
+    {
+        // Resolving the frame can swap the current scene, keep the one the systems ran on alive
+        const auto scene = m_CurrentScene;
+        m_Systems.run(*scene, Time::getDeltaTime());
+        resolveFrame(*scene);
+    }
+    if constexpr (c_InstantRetryTicks > 0) {
+        m_Snapshots.capture(*m_CurrentScene, {m_Score, m_Lives});
     }
 
     updateUI();
+    m_HUD.updateTransforms();
 
 
     m_Renderer.render(*m_CurrentScene);
     m_Renderer.render(m_HUD, false);
 
     m_Renderer.flush();
+    Latency::onFramePresented();
 
     Time::endTimeUpdate();
+    m_CurrentScene->endFrame();
+    m_CurrentScene->traceStats("Level");
+    m_HUD.endFrame();
+    m_HUD.traceStats("HUD");
+    FrameArena::reset();
+    MemoryTracker::endFrame();
 }
 
 
+void Game::registerSystems() {
+    // Systems never create or destroy entities nor swap the scene, they leave their outcome
+    // in members that resolveFrame applies once every system is done
+    m_Systems.addSystem("GameLogic",
+                        SystemAccess{}.reads<TagComponent>().writes<TransformComponent, BallComponent>(),
+                        [this](Scene &scene, f32 dt) { handleGameLogic(scene, dt); });
+    // Only reads the tile counter, runs next to the game logic
+    m_Systems.addSystem("LevelProgress",
+                        SystemAccess{}.reads<TileComponent>(),
+                        [this](Scene &scene, f32) {
+                            m_LevelCleared = scene.getTileCount(TileType::BREAKABLE) == 0;
+                        });
+    m_Systems.addSystem("Physics",
+                        SystemAccess{}.reads<TagComponent, TileComponent>()
+                                .writes<TransformComponent, BallComponent>(),
+                        [this](Scene &scene, f32 dt) {
+                            // Physics substepping
+                            for (u32 i = 0; i < 4; i++) {
+                                handlePhysics(scene, dt / 4);
+                            }
+                        });
+    // Places everything attached to another entity once the frame moved it. Writes the
+    // relationships too, a changed hierarchy is re-sorted on the next pass
+    m_Systems.addSystem("Transforms",
+                        SystemAccess{}.writes<TransformComponent, RelationshipComponent>(),
+                        [](Scene &scene, f32) { scene.updateTransforms(); });
+}
+
 void Game::handleInput() {
     // handle all queued inputs
     auto *inputBuffer = android_app_swap_input_buffers(m_App);
@@ -55,6 +176,7 @@ void Game::handleInput() {
     for (auto i = 0; i < inputBuffer->motionEventsCount; i++) {
         auto &motionEvent = inputBuffer->motionEvents[i];
         auto action = motionEvent.action;
+        Latency::onInputReceived();
 
         // Find the pointer index, mask and bitshift to turn it into a readable value.
         auto pointerIndex = (action & AMOTION_EVENT_ACTION_POINTER_INDEX_MASK)
@@ -113,8 +235,6 @@ void Game::handleInput() {
 // A number higher than 1: a destroyable brick; each subsequent number only differs in color.
 
 void Game::loadLevelElements(const std::string &level) {
-    std::vector<std::vector<u32>> tileData;
-
     FILE *levelFile = android_fopen(level.c_str(), "r");
 
     if (levelFile == nullptr) {
@@ -125,17 +245,27 @@ void Game::loadLevelElements(const std::string &level) {
     char *line = nullptr;
     size_t len = 0;
 
-    u32 tileCode;
+    // Tiles are stored row by row, the parse buffer only lives until the end of the frame
+    auto tileData = FrameArena::makeVector<u32>();
+    u32 width = 0;
     while (getline(&line, &len, levelFile) != -1) {
-        std::vector<u32> row;
-        std::istringstream sstream(line);
-        while (sstream >> tileCode) {
-            row.emplace_back(tileCode);
+        u32 rowWidth = 0;
+        char *cursor = line;
+        char *end = nullptr;
+        for (u32 tileCode = strtoul(cursor, &end, 10); end != cursor;
+             tileCode = strtoul(cursor, &end, 10)) {
+            tileData.emplace_back(tileCode);
+            cursor = end;
+            rowWidth++;
         }
-        tileData.emplace_back(row);
+        if (rowWidth == 0) {
+            continue;
+        }
+        width = width == 0 ? rowWidth : width;
+        tileData.resize(tileData.size() - rowWidth + width, 0);
     }
     if (!tileData.empty()) {
-        createLevelElements(tileData);
+        createLevelElements(tileData, width);
     }
 
     fclose(levelFile);
@@ -144,34 +274,35 @@ void Game::loadLevelElements(const std::string &level) {
     }
 }
 
-void Game::createLevelElements(const std::vector<std::vector<u32>> &tileData) {
+void Game::createLevelElements(const FrameArena::Vector<u32> &tileData, u32 width) {
+    MemoryScope memoryScope(MemoryTag::Scene);
 
     auto &scene = m_Levels.emplace_back();
 
     const u32 levelHeight = ANativeWindow_getHeight(m_App->window) / 2;
     const u32 levelWidth = ANativeWindow_getWidth(m_App->window);
 
-    const u32 height = tileData.size();
-    const u32 width = tileData[0].size();
+    const u32 height = tileData.size() / width;
+
 
+    // Bricks are created in one batch, component by component
+    auto transforms = FrameArena::makeVector<TransformComponent>(tileData.size());
+    auto tiles = FrameArena::makeVector<TileComponent>(tileData.size());
+    auto sprites = FrameArena::makeVector<SpriteComponent>(tileData.size());
 
     const f32 offset = (levelWidth / static_cast<float>(width));
     for (u32 y = 0; y < height; y++) {
         for (u32 x = 0; x < width; x++) {
             V3 position = V3{offset / 2 + offset * x, offset / 2 + offset * y, 0.0f};
             V3 scale = V3{offset * 0.5, offset * 0.5, 1.0};
-            if (tileData[y][x] == 1) { // Solid block
-                Entity brick = scene.createEntity("Brick");
-                auto &transform = brick.getComponent<TransformComponent>();
-                transform.Translation = position;
-                transform.Scale = scale;
-
-                brick.addComponent<TileComponent>(TileComponent(TileType::SOLID));
-                brick.addComponent<SpriteComponent>(SpriteComponent({0.8f, 0.8f, 0.8f}, 0));
-            } else if (tileData[y][x] > 1) {
+            if (tileData[y * width + x] == 1) { // Solid block
+                transforms.emplace_back(position, Quaternion{1.0f, 0.0f, 0.0f, 0.0f}, scale);
+                tiles.emplace_back(TileType::SOLID);
+                sprites.emplace_back(V3{0.8f, 0.8f, 0.8f}, m_BlockSolidTexture.getId());
+            } else if (tileData[y * width + x] > 1) {
                 Color color = Color{1.0};
 
-                switch (tileData[y][x]) {
+                switch (tileData[y * width + x]) {
                     case 2:
                         color = {0.2f, 0.6f, 1.0f};
                         break;
@@ -186,16 +317,15 @@ void Game::createLevelElements(const std::vector<std::vector<u32>> &tileData) {
                         break;
                 }
 
-                Entity brick = scene.createEntity("Brick");
-                auto &transform = brick.getComponent<TransformComponent>();
-                transform.Translation = position;
-                transform.Scale = scale;
-
-                brick.addComponent<TileComponent>(TileComponent(TileType::BREAKABLE));
-                brick.addComponent<SpriteComponent>(SpriteComponent(color, 1));
+                transforms.emplace_back(position, Quaternion{1.0f, 0.0f, 0.0f, 0.0f}, scale);
+                tiles.emplace_back(TileType::BREAKABLE);
+                sprites.emplace_back(color, m_BlockTexture.getId());
             }
         }
     }
+    scene.createEntities(c_BrickTag, static_cast<u32>(transforms.size()), transforms.data(),
+                         tiles.data(), sprites.data());
+
     // Create the player
     {
         Entity player = scene.createEntity(c_PlayerTag);
@@ -203,7 +333,7 @@ void Game::createLevelElements(const std::vector<std::vector<u32>> &tileData) {
         transform.Translation = {levelWidth / 2, levelHeight * 1.75, 0.0f};
         transform.Scale = {200, 50, 1.0f};
 
-        player.addComponent<SpriteComponent>(SpriteComponent(2));
+        player.addComponent<SpriteComponent>(SpriteComponent(m_PaddleTexture.getId()));
         player.addComponent<PlayerComponent>();
     }
     // Create the ball
@@ -214,16 +344,16 @@ void Game::createLevelElements(const std::vector<std::vector<u32>> &tileData) {
         transform.Scale = {50.f, 50.f, 1.f};
 
         ball.addComponent<BallComponent>(BallComponent(c_BallVelocity, 50.f));
-        ball.addComponent<SpriteComponent>(SpriteComponent(3));
+        ball.addComponent<SpriteComponent>(SpriteComponent(m_BallTexture.getId()));
     }
 
 }
 
 void Game::loadAssets() {
-    m_Renderer.loadTexture("Textures/block_solid.png");
-    m_Renderer.loadTexture("Textures/block.png");
-    m_Renderer.loadTexture("Textures/paddle.png");
-    m_Renderer.loadTexture("Textures/awesomeface.png");
+    m_BlockSolidTexture = m_Renderer.loadTexture("Textures/block_solid.png");
+    m_BlockTexture = m_Renderer.loadTexture("Textures/block.png");
+    m_PaddleTexture = m_Renderer.loadTexture("Textures/paddle.png");
+    m_BallTexture = m_Renderer.loadTexture("Textures/awesomeface.png");
 }
 
 void Game::loadLevels() {
@@ -232,21 +362,55 @@ void Game::loadLevels() {
     loadLevelElements("Levels/level03.txt");
 }
 
-void Game::handleGameLogic() {
-    const f32 dt = Time::getDeltaTime();
-
-    if (!m_CurrentScene) {
+void Game::handleMenu() {
+    Entity menu = m_HUD.findEntityByName(c_MenuTag);
+    menu.getComponent<TransformComponent>().Enabled = m_GameState == GameState::RETRY;
+    if (m_GameState != GameState::RETRY) {
         return;
     }
 
+    // Measuring the text can rasterize glyphs, keep it on the GL thread
+    {
+        Entity retry = m_HUD.findEntityByName(c_RetryTag);
+        const auto &transform = retry.getComponent<TransformComponent>();
 
-    auto player = m_CurrentScene->findEntityByName(c_PlayerTag);
+        const V2 size = m_Renderer.measureText(retry.getComponent<TextComponent>())
+                        * V2{transform.Scale.x, transform.Scale.y};
+        Rect rect = Rect{static_cast<u32>(size.x), static_cast<u32>(size.y),
+                         transform.Translation.x, transform.Translation.y};
+
+        if (m_Input.TouchedScreen) {
+            if (checkInside(rect, V2{m_Input.LastPosX, m_Input.LastPosY})) {
+                m_GameState = GameState::START;
+                m_Input.TouchedScreen = false;
+            }
+        }
+    }
+
+    {
+        Entity exit = m_HUD.findEntityByName(c_ExitTag);
+        const auto &transform = exit.getComponent<TransformComponent>();
+
+        const V2 size = m_Renderer.measureText(exit.getComponent<TextComponent>())
+                        * V2{transform.Scale.x, transform.Scale.y};
+        Rect rect = Rect{static_cast<u32>(size.x), static_cast<u32>(size.y),
+                         transform.Translation.x, transform.Translation.y};
+
+        if (m_Input.TouchedScreen &&
+            checkInside(rect, V2{m_Input.LastPosX, m_Input.LastPosY})) {
+            GameActivity_finish(m_App->activity);
+        }
+    }
+}
+
+void Game::handleGameLogic(Scene &scene, f32 dt) {
+    auto player = scene.findEntityByName(c_PlayerTag);
     if (!player) {
         return;
     }
 
     auto &playerTransform = player.getComponent<TransformComponent>();
-    auto ball = m_CurrentScene->findEntityByName(c_BallTag);
+    auto ball = scene.findEntityByName(c_BallTag);
     if (!ball) {
         return;
     }
@@ -264,24 +428,6 @@ void Game::handleGameLogic() {
             ballTransform.Translation = playerTransform.Translation +
                                         V3{playerTransform.Scale.x / 2.0f - (ballCmp.Radius * 2.0f),
                                            -ballCmp.Radius * 2.0f, 0.0f};
-
-            {
-                Entity gameOver = m_HUD.findEntityByName("GameOver");
-                auto &transform = gameOver.getComponent<TransformComponent>();
-                transform.Enabled = false;
-            }
-
-            {
-                Entity retry = m_HUD.findEntityByName("Retry");
-                auto &transform = retry.getComponent<TransformComponent>();
-                transform.Enabled = false;
-            }
-
-            {
-                Entity exit = m_HUD.findEntityByName("Exit");
-                auto &transform = exit.getComponent<TransformComponent>();
-                transform.Enabled = false;
-            }
         }
             break;
         case GameState::PLAYING: {
@@ -302,92 +448,32 @@ void Game::handleGameLogic() {
                 ballCmp.Speed.y = -ballCmp.Speed.y;
                 ballPos.y = 0.0f;
             } else if (ballPos.y >= m_Renderer.height()) {
-                m_Lives--;
-                restartLevel();
-
-                if (m_Lives <= 0) {
-                    restartGame();
-                }
+                m_BallLost = true;
             }
-
-            auto view = m_CurrentScene->getAllEntitiesWith<TileComponent>();
-            u32 brickCount = 0;
-
-            for (const auto &entity: view) {
-                auto &brick = view.get<TileComponent>(entity);
-                if (brick.Type != TileType::SOLID) {
-                    brickCount++;
-                }
-            }
-
-            if (brickCount == 0) {
-                nextLevel();
-            }
-
-
         }
             break;
-        case GameState::RETRY: {
-
-            {
-                Entity gameOver = m_HUD.findEntityByName("GameOver");
-                auto &transform = gameOver.getComponent<TransformComponent>();
-                transform.Enabled = true;
-            }
-
-            {
-                Entity retry = m_HUD.findEntityByName("Retry");
-                auto &transform = retry.getComponent<TransformComponent>();
-                transform.Enabled = true;
-
-                Rect rect = Rect{150, 50, transform.Translation.x, transform.Translation.y};
-
-                if (m_Input.TouchedScreen) {
-                    if (checkInside(rect, V2{m_Input.LastPosX, m_Input.LastPosY})) {
-                        m_GameState = GameState::START;
-                        m_Input.TouchedScreen = false;
-                    }
-                }
-            }
-
-            {
-                Entity exit = m_HUD.findEntityByName("Exit");
-                auto &transform = exit.getComponent<TransformComponent>();
-                transform.Enabled = true;
-
-                Rect rect = Rect{150, 50, transform.Translation.x, transform.Translation.y};
-
-                if (m_Input.TouchedScreen &&
-                    checkInside(rect, V2{m_Input.LastPosX, m_Input.LastPosY})) {
-                    GameActivity_finish(m_App->activity);
-                }
-            }
-
-
-        }
+        case GameState::RETRY:
+            // The menu is handled on the main thread
             break;
     }
-
-    // Handle touch input
-
 }
 
-void Game::handlePhysics(f32 dt) {
-    if (!m_CurrentScene) {
-        return;
-    }
-
-    auto view = m_CurrentScene->getAllEntitiesWith<IDComponent, TransformComponent, TileComponent>();
-    auto ball = m_CurrentScene->findEntityByName(c_BallTag);
-    auto player = m_CurrentScene->findEntityByName(c_PlayerTag);
+void Game::handlePhysics(Scene &scene, f32 dt) {
+    auto colliders = scene.getColliders();
+    auto ball = scene.findEntityByName(c_BallTag);
+    auto player = scene.findEntityByName(c_PlayerTag);
 
     auto &ballTransform = ball.getComponent<TransformComponent>();
     auto &ballCmp = ball.getComponent<BallComponent>();
 
-    for (auto &entity: view) {
-        auto &uuid = view.get<IDComponent>(entity);
-        auto brick = m_CurrentScene->getEntityByUuid(uuid.ID);
-        auto &brickCmp = brick.getComponent<TileComponent>();
+    for (auto entity: colliders) {
+        // Broken bricks are only destroyed after the systems ran
+        if (std::find(m_BrokenBricks.begin(), m_BrokenBricks.end(), entity) != m_BrokenBricks.end()) {
+            continue;
+        }
+
+        Entity brick{entity, &scene};
+        const auto brickType = colliders.get<TileComponent>(entity).Type;
 
 
         const auto &collision = checkCollision(brick, ball);
@@ -408,9 +494,9 @@ void Game::handlePhysics(f32 dt) {
                 ballTransform.Translation.y += dir == Direction::UP ? pen : -pen;
             }
 
-            if (brickCmp.Type != TileType::SOLID) {
+            if (brickType != TileType::SOLID) {
                 m_Score++;
-                m_CurrentScene->destroyEntity(brick);
+                m_BrokenBricks.push_back(entity);
             }
         }
     }
@@ -475,13 +561,63 @@ Collision Game::checkCollision(Entity &object, Entity &ball) {
     return std::make_tuple(false, Direction::UP, V2{0.0f});
 }
 
+void Game::resolveFrame(Scene &scene) {
+    for (auto entity: m_BrokenBricks) {
+        scene.destroyEntity(Entity{entity, &scene});
+    }
+    m_BrokenBricks.clear();
+
+    if (m_BallLost) {
+        m_BallLost = false;
+        m_Lives--;
+        if (m_Lives <= 0 || !rewind(c_InstantRetryTicks)) {
+            restartLevel();
+        }
+
+        if (m_Lives <= 0) {
+            restartGame();
+        }
+    } else if (m_LevelCleared && m_GameState == GameState::PLAYING) {
+        nextLevel();
+    }
+    m_LevelCleared = false;
+}
+
+void Game::setCurrentScene(Scene &level) {
+    setCurrentScene(Scene::copy(level));
+}
+
+void Game::setCurrentScene(std::shared_ptr<Scene> scene) {
+    m_CurrentScene = std::move(scene);
+    if constexpr (c_InstantRetryTicks > 0) {
+        m_Snapshots.reset(*m_CurrentScene);
+    }
+}
+
+bool Game::rewind(u32 ticks) {
+    SnapshotCounters counters;
+    if (ticks == 0 || !m_Snapshots.restore(*m_CurrentScene, ticks, counters)) {
+        return false;
+    }
+
+    // Lives are not given back, the miss still counts
+    m_Score = counters.Score;
+
+    // A few ticks before the miss the ball is still heading past the paddle, serve it again
+    if (Entity ball = m_CurrentScene->findEntityByName(c_BallTag)) {
+        ball.getComponent<BallComponent>().Speed = c_BallVelocity;
+    }
+    m_GameState = GameState::START;
+    return true;
+}
+
 void Game::restartLevel() {
-    m_CurrentScene = Scene::copy(m_Levels[0]);
+    setCurrentScene(m_Levels[0]);
     m_GameState = GameState::START;
 }
 
 void Game::restartGame() {
-    m_CurrentScene = Scene::copy(m_Levels[0]);
+    setCurrentScene(m_Levels[0]);
     m_GameState = GameState::RETRY;
     m_Score = 0;
     m_CurrentLevel = 0;
@@ -491,72 +627,92 @@ void Game::restartGame() {
 void Game::nextLevel() {
     m_CurrentLevel++;
     if (m_CurrentLevel < m_Levels.size()) {
-        m_CurrentScene = Scene::copy(m_Levels[m_CurrentLevel]);
+        setCurrentScene(m_Levels[m_CurrentLevel]);
     } else {
-        m_CurrentScene = Scene::copy(m_Levels[m_Levels.size() - 1]);
+        setCurrentScene(m_Levels[m_Levels.size() - 1]);
     }
 
     m_GameState = GameState::START;
 }
 
 void Game::loadUI() {
+    MemoryScope memoryScope(MemoryTag::Scene);
     const u32 levelWidth = ANativeWindow_getWidth(m_App->window);
     const u32 levelHeight = ANativeWindow_getHeight(m_App->window);
     {
-        Entity score = m_HUD.createEntity("Score");
+        Entity score = m_HUD.createEntity(c_ScoreTag);
         auto &transform = score.getComponent<TransformComponent>();
         transform.Translation = {0.f, 150.f, 0.0f};
         transform.Scale = {2.f, 2.f, 1.f};
         score.addComponent<TextComponent>(TextComponent("Score", V3{1.0, 1.0, 0.0}));
+        m_ScoreBinding = NumericTextBinding(score, "Score: ");
     }
     {
-        Entity score = m_HUD.createEntity("Lives");
-        auto &transform = score.getComponent<TransformComponent>();
+        Entity lives = m_HUD.createEntity(c_LivesTag);
+        auto &transform = lives.getComponent<TransformComponent>();
         transform.Translation = {0, 0, 0.0f};
         transform.Scale = {2.f, 2.f, 1.f};
-        score.addComponent<TextComponent>(TextComponent("Lives", V3{1.0, 1.0, 0.0}));
+        lives.addComponent<TextComponent>(TextComponent("Lives", V3{1.0, 1.0, 0.0}));
+        m_LivesBinding = NumericTextBinding(lives, "Lives: ");
     }
+    // The game over menu is laid out relative to its anchor, hiding the anchor hides all of it
+    Entity menu = m_HUD.createEntity(c_MenuTag);
     {
-        Entity gameOver = m_HUD.createEntity("GameOver");
-        auto &transform = gameOver.getComponent<TransformComponent>();
+        auto &transform = menu.getComponent<TransformComponent>();
         transform.Translation = {levelWidth / 2 - 250.f, levelHeight / 2, 0.0f};
-        transform.Scale = {2.f, 2.f, 1.f};
         transform.Enabled = false;
+    }
+
+    {
+        Entity gameOver = m_HUD.createEntity(c_GameOverTag);
+        auto &transform = gameOver.getComponent<TransformComponent>();
+        transform.Scale = {2.f, 2.f, 1.f};
         gameOver.addComponent<TextComponent>(TextComponent("Game Over", V3{1.0, 1.0, 0.0}));
+        m_HUD.setParent(gameOver, menu);
     }
 
     {
-        Entity retry = m_HUD.createEntity("Retry");
+        Entity retry = m_HUD.createEntity(c_RetryTag);
         auto &transform = retry.getComponent<TransformComponent>();
-        transform.Translation = {levelWidth / 2 - 250.f, levelHeight / 2 + 150, 0.0f};
+        transform.Translation = {0.f, 150.f, 0.0f};
         transform.Scale = {2.f, 2.f, 1.f};
-        transform.Enabled = false;
         retry.addComponent<TextComponent>(TextComponent("Retry", V3{1.0, 1.0, 0.0}));
+        m_HUD.setParent(retry, menu);
     }
 
     {
-        Entity exit = m_HUD.createEntity("Exit");
+        Entity exit = m_HUD.createEntity(c_ExitTag);
         auto &transform = exit.getComponent<TransformComponent>();
-        transform.Translation = {levelWidth / 2 - 250.f, levelHeight / 2 + 300, 0.0f};
+        transform.Translation = {0.f, 300.f, 0.0f};
         transform.Scale = {2.f, 2.f, 1.f};
-        transform.Enabled = false;
         exit.addComponent<TextComponent>(TextComponent("Exit", V3{1.0, 1.0, 0.0}));
+        m_HUD.setParent(exit, menu);
+    }
+
+    if (c_ShowLatencyOverlay) {
+        Entity latency = m_HUD.createEntity(c_LatencyTag);
+        auto &transform = latency.getComponent<TransformComponent>();
+        transform.Translation = {0.f, levelHeight - 100.f, 0.0f};
+        transform.Scale = {1.f, 1.f, 1.f};
+        latency.addComponent<TextComponent>(TextComponent("Latency", V3{1.0, 1.0, 1.0}));
     }
 
 }
 
 void Game::updateUI() {
-
-    {
-        Entity score = m_HUD.findEntityByName("Score");
-        auto &text = score.getComponent<TextComponent>();
-        text.Text = "Score: " + std::to_string(m_Score);
-    }
-
-    {
-        Entity lives = m_HUD.findEntityByName("Lives");
-        auto &text = lives.getComponent<TextComponent>();
-        text.Text = "Lives: " + std::to_string(m_Lives);
+    // Bindings only reformat their text when the value changed
+    m_ScoreBinding.set(m_Score);
+    m_LivesBinding.set(m_Lives);
+
+    if (c_ShowLatencyOverlay) {
+        const auto percentiles = Latency::getPercentiles();
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "p50 %.1f p95 %.1f p99 %.1f ms",
+                 percentiles.P50, percentiles.P95, percentiles.P99);
+
+        Entity latency = m_HUD.findEntityByName(c_LatencyTag);
+        auto &text = latency.getComponent<TextComponent>();
+        text.setText(buffer);
     }
 
 }
@@ -3,6 +3,11 @@
 
 
 #include <Renderer/Renderer.h>
+#include <Memory/FrameArena.h>
+#include <Core/ThreadPool.h>
+#include <ECS/SystemScheduler.h>
+#include <ECS/SceneSnapshots.h>
+#include <UI/TextBinding.h>
 
 struct android_app;
 
@@ -45,7 +50,17 @@ public:
     virtual ~Game();
 
 
-    void startGame();
+    /*!
+     * Loads the assets and levels and starts playing
+     * @param savedState state returned by saveState, resumes that game instead of the first level
+     */
+    void startGame(const std::vector<u8> &savedState = {});
+
+    /*!
+     * Serializes the current level and the game counters
+     * @return the state to give to startGame once the game is recreated
+     */
+    std::vector<u8> saveState() const;
     /*!
      * Handles input from the android_app.
      *
@@ -61,8 +76,11 @@ public:
 private:
 
 
-    void handleGameLogic();
-    void handlePhysics(f32 dt);
+    void registerSystems();
+    void handleMenu();
+    void handleGameLogic(Scene &scene, f32 dt);
+    void handlePhysics(Scene &scene, f32 dt);
+    void resolveFrame(Scene &scene);
 
     bool checkInside(const Rect& rect, const V2& pointer);
 
@@ -76,18 +94,38 @@ private:
     void updateUI();
 
     void loadLevelElements(const std::string& level);
-    void createLevelElements(const std::vector<std::vector<u32>>& tileData);
+    void createLevelElements(const FrameArena::Vector<u32>& tileData, u32 width);
     void restartGame();
     void restartLevel();
     void nextLevel();
+    bool restoreState(const std::vector<u8> &state);
+    void setCurrentScene(Scene &level);
+    void setCurrentScene(std::shared_ptr<Scene> scene);
+    bool rewind(u32 ticks);
 
     android_app *m_App;
     Renderer m_Renderer;
 
+    // Declared after the renderer, released before its texture registry goes away
+    TextureHandle m_BlockSolidTexture;
+    TextureHandle m_BlockTexture;
+    TextureHandle m_PaddleTexture;
+    TextureHandle m_BallTexture;
+
+    ThreadPool m_ThreadPool;
+    SystemScheduler m_Systems{m_ThreadPool};
+
     Scene m_HUD;
     std::vector<Scene> m_Levels{};
     std::shared_ptr<Scene> m_CurrentScene = nullptr;
+    SceneSnapshots m_Snapshots;
+    NumericTextBinding m_ScoreBinding;
+    NumericTextBinding m_LivesBinding;
     PlayerInput m_Input = {};
+    // Outcomes of the systems, applied on the main thread once they are done
+    std::vector<entt::entity> m_BrokenBricks{};
+    bool m_BallLost = false;
+    bool m_LevelCleared = false;
     u32 m_Score = 0;
     u32 m_Lives = c_MaxLives;
     u32 m_CurrentLevel = 0;
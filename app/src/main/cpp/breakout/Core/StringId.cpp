@@ -0,0 +1,213 @@
+#include "StringId.h"
+
+#include <atomic>
+#include <cassert>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace
+{
+	//! FNV-1a
+	u32 hashString(std::string_view string)
+	{
+		u32 hash = 2166136261u;
+		for (char c: string)
+		{
+			hash = (hash ^ static_cast<u8>(c)) * 16777619u;
+		}
+		return hash;
+	}
+
+	//! Global string table
+	/*
+	* Strings are stored in a deque, which never moves its elements, so the views handed
+	* out stay valid. The index is an open addressing table of entry ids keyed by the
+	* stored hashes, growing never rehashes a string.
+	* Entries live in blocks that double in size and never move, an entry is
+	* written before its id is handed out, so str() reads it without taking the lock.
+	*/
+	class StringInterner
+	{
+	public:
+		StringInterner()
+		{
+			// Id 0 is the empty string
+			m_Strings.emplace_back();
+			push({std::string_view{}, hashString({})});
+			m_Slots.assign(64, c_EmptySlot);
+		}
+
+		~StringInterner()
+		{
+			for (std::atomic<Entry *> &block: m_Blocks)
+			{
+				delete[] block.load(std::memory_order_relaxed);
+			}
+		}
+
+		//! @return The id of the string
+		u32 intern(std::string_view string, u32 hash)
+		{
+			if (string.empty())
+			{
+				return 0;
+			}
+
+			std::lock_guard lock(m_Mutex);
+			size_t slot = findSlot(string, hash);
+			if (m_Slots[slot] != c_EmptySlot)
+			{
+				return m_Slots[slot];
+			}
+
+			const std::string &stored = m_Strings.emplace_back(string);
+			const u32 id = push({stored, hash});
+			m_Slots[slot] = id;
+
+			// Keep the load factor under 1/2
+			if (m_Count * 2 > m_Slots.size())
+			{
+				grow();
+			}
+			return id;
+		}
+
+		u32 find(std::string_view string, u32 hash)
+		{
+			if (string.empty())
+			{
+				return 0;
+			}
+
+			std::lock_guard lock(m_Mutex);
+			const u32 id = m_Slots[findSlot(string, hash)];
+			return id == c_EmptySlot ? 0 : id;
+		}
+
+		//! Lock free, the id must come from intern() or find()
+		std::string_view str(u32 id) const
+		{
+			return getEntry(id).String;
+		}
+
+	private:
+		struct Entry
+		{
+			std::string_view String;
+			u32 Hash;
+		};
+
+		static constexpr u32 c_EmptySlot = ~0u;
+
+		// Block b holds c_FirstBlockSize << b entries, enough blocks for every u32 id
+		static constexpr u32 c_FirstBlockSize = 64;
+		static constexpr u32 c_BlockCount = 26;
+
+		//! @return The block holding the id, and the index of its first entry
+		static u32 getBlock(u32 id, u32 &first)
+		{
+			const u32 block = 31 - __builtin_clz(id / c_FirstBlockSize + 1);
+			first = c_FirstBlockSize * ((1u << block) - 1);
+			return block;
+		}
+
+		const Entry &getEntry(u32 id) const
+		{
+			u32 first;
+			const u32 block = getBlock(id, first);
+			return m_Blocks[block].load(std::memory_order_acquire)[id - first];
+		}
+
+		//! Appends an entry, the lock must be held
+		u32 push(const Entry &entry)
+		{
+			const u32 id = m_Count;
+			u32 first;
+			const u32 block = getBlock(id, first);
+			assert(block < c_BlockCount && "StringId: too many interned strings");
+			Entry *entries = m_Blocks[block].load(std::memory_order_relaxed);
+			if (entries == nullptr)
+			{
+				entries = new Entry[c_FirstBlockSize << block];
+				m_Blocks[block].store(entries, std::memory_order_release);
+			}
+			entries[id - first] = entry;
+			m_Count++;
+			return id;
+		}
+
+		//! @return The slot holding the string, or the empty slot it would go in
+		size_t findSlot(std::string_view string, u32 hash) const
+		{
+			const size_t mask = m_Slots.size() - 1;
+			for (size_t slot = hash & mask;; slot = (slot + 1) & mask)
+			{
+				const u32 id = m_Slots[slot];
+				if (id == c_EmptySlot)
+				{
+					return slot;
+				}
+				const Entry &entry = getEntry(id);
+				if (entry.Hash == hash && entry.String == string)
+				{
+					return slot;
+				}
+			}
+		}
+
+		void grow()
+		{
+			std::vector<u32> slots(m_Slots.size() * 2, c_EmptySlot);
+			const size_t mask = slots.size() - 1;
+			for (u32 id = 1; id < m_Count; id++)
+			{
+				size_t slot = getEntry(id).Hash & mask;
+				while (slots[slot] != c_EmptySlot)
+				{
+					slot = (slot + 1) & mask;
+				}
+				slots[slot] = id;
+			}
+			m_Slots = std::move(slots);
+		}
+
+		std::mutex m_Mutex;
+		std::deque<std::string> m_Strings;
+		std::atomic<Entry *> m_Blocks[c_BlockCount]{};
+		u32 m_Count = 0;
+		std::vector<u32> m_Slots;
+	};
+
+	// Constructed on first use, so StringIds can be created from static initializers
+	StringInterner &getInterner()
+	{
+		static StringInterner s_Interner;
+		return s_Interner;
+	}
+}
+
+StringId::StringId(std::string_view string)
+		: m_Hash(hashString(string))
+{
+	m_Id = getInterner().intern(string, m_Hash);
+}
+
+StringId StringId::find(std::string_view string)
+{
+	StringId id;
+	const u32 hash = hashString(string);
+	id.m_Id = getInterner().find(string, hash);
+	if (id.m_Id != 0)
+	{
+		id.m_Hash = hash;
+	}
+	return id;
+}
+
+std::string_view StringId::str() const
+{
+	return getInterner().str(m_Id);
+}
@@ -0,0 +1,87 @@
+/*
+MIT License
+
+Copyright (c) 2023 Victor Falcon Zaro
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <Common.h>
+#include <string_view>
+
+//! Interned string identifier
+//! Equal strings share the same 32 bit id, so comparing them is a single integer compare.
+//! The hash travels with the id and reading the string back never locks.
+//! Interned strings live until the process ends, only use it for names from a small set
+class StringId
+{
+public:
+	//! Default constructor, the empty string
+	StringId() = default;
+
+	//! Interns a string
+	//! @param string The string to intern, copied on its first use
+	explicit StringId(std::string_view string);
+
+	//! Finds an already interned string, without interning it
+	//! @param string The string to look up
+	//! @return Its id, the empty string if it was never interned
+	static StringId find(std::string_view string);
+
+	//! @return The interned string, valid for the lifetime of the process
+	std::string_view str() const;
+
+	//! @return The hash of the string, computed once when it was interned
+	u32 getHash() const { return m_Hash; }
+
+	//! @return The raw id, 0 for the empty string
+	u32 getId() const { return m_Id; }
+
+	bool empty() const { return m_Id == 0; }
+
+	bool operator==(const StringId &other) const { return m_Id == other.m_Id; }
+
+	bool operator!=(const StringId &other) const { return m_Id != other.m_Id; }
+
+private:
+	u32 m_Id = 0;
+	u32 m_Hash = c_EmptyHash;
+
+	//! FNV-1a offset basis, the hash of the empty string
+	static constexpr u32 c_EmptyHash = 2166136261u;
+};
+
+
+namespace std
+{
+	//! STD Hash StringId implementation
+	template<>
+	struct hash<StringId>
+	{
+		//! Returns the hash precomputed by the interner
+		//! @param id StringId to hash
+		std::size_t operator()(const StringId &id) const noexcept
+		{
+			return id.getHash();
+		}
+	};
+
+}
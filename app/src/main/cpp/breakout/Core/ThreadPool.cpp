@@ -0,0 +1,112 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(u32 workers)
+		: m_WorkerCount(workers)
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard lock(m_Mutex);
+		m_Stop = true;
+	}
+	m_WakeUp.notify_all();
+	for (auto &worker: m_Workers)
+	{
+		worker.join();
+	}
+}
+
+u32 ThreadPool::defaultWorkerCount()
+{
+	const u32 hardware = std::thread::hardware_concurrency();
+	return hardware > 1 ? hardware - 1 : 0;
+}
+
+void ThreadPool::parallelFor(u32 count, JobRef job)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	// Not worth waking anyone up for a single job
+	if (count == 1 || m_WorkerCount == 0)
+	{
+		for (u32 i = 0; i < count; i++)
+		{
+			job(i);
+		}
+		return;
+	}
+
+	if (m_Workers.empty())
+	{
+		startWorkers();
+	}
+
+	{
+		std::lock_guard lock(m_Mutex);
+		m_Job = &job;
+		m_Count = count;
+		m_Next.store(0, std::memory_order_relaxed);
+		m_Batch++;
+	}
+	m_WakeUp.notify_all();
+
+	runJobs(job, count);
+
+	// Every index is taken, wait for the workers still running one. Clearing the job under
+	// the lock means no worker can join this batch late
+	std::unique_lock lock(m_Mutex);
+	m_Done.wait(lock, [this] { return m_Active == 0; });
+	m_Job = nullptr;
+}
+
+void ThreadPool::startWorkers()
+{
+	m_Workers.reserve(m_WorkerCount);
+	for (u32 i = 0; i < m_WorkerCount; i++)
+	{
+		m_Workers.emplace_back(&ThreadPool::workerLoop, this);
+	}
+}
+
+void ThreadPool::workerLoop()
+{
+	u64 batch = 0;
+	while (true)
+	{
+		const JobRef *job = nullptr;
+		u32 count = 0;
+		{
+			std::unique_lock lock(m_Mutex);
+			m_WakeUp.wait(lock, [this, batch] { return m_Stop || (m_Batch != batch && m_Job); });
+			if (m_Stop)
+			{
+				return;
+			}
+			batch = m_Batch;
+			job = m_Job;
+			count = m_Count;
+			m_Active++;
+		}
+
+		runJobs(*job, count);
+
+		std::lock_guard lock(m_Mutex);
+		if (--m_Active == 0)
+		{
+			m_Done.notify_one();
+		}
+	}
+}
+
+void ThreadPool::runJobs(const JobRef &job, u32 count)
+{
+	for (u32 i = m_Next.fetch_add(1, std::memory_order_relaxed); i < count; i = m_Next.fetch_add(1, std::memory_order_relaxed))
+	{
+		job(i);
+	}
+}
@@ -0,0 +1,107 @@
+/*
+MIT License
+
+Copyright (c) 2023 Victor Falcon Zaro
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef _THREAD_POOL_H_
+#define _THREAD_POOL_H_
+
+#include <Common.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+//! Fixed set of worker threads running batches of jobs
+/*
+*	A batch is a function called once per index. The calling thread takes part in it
+*	and returns when every index has run, so batches never outlive the data they use.
+*	Batches are run one at a time. The workers are only started by the first batch that
+*	can use them, a pool that never gets one costs no threads.
+*/
+class ThreadPool
+{
+public:
+	//! Non owning reference to the job of a batch
+	//! Unlike std::function it never allocates, the callable must outlive the batch
+	class JobRef
+	{
+	public:
+		template<typename Function, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Function>, JobRef>>>
+		JobRef(const Function &function)
+				: m_Function(&function),
+				  m_Call([](const void *function, u32 index) { (*static_cast<const Function *>(function))(index); })
+		{
+		}
+
+		void operator()(u32 index) const { m_Call(m_Function, index); }
+
+	private:
+		const void *m_Function;
+		void (*m_Call)(const void *, u32);
+	};
+
+	//! Constructor
+	//! @param workers Amount of worker threads, by default one less than the hardware threads.
+	//! Started on the first batch of more than one job
+	explicit ThreadPool(u32 workers = defaultWorkerCount());
+
+	//! Destructor
+	//! Stops and joins the workers
+	~ThreadPool();
+
+	DISABLE_MOVE_AND_COPY(ThreadPool)
+
+	//! Runs job(0) ... job(count - 1) across the workers and the calling thread
+	//! @param count Amount of jobs
+	//! @param job Function called with the index of each job
+	void parallelFor(u32 count, JobRef job);
+
+	//! @return Amount of worker threads, not counting the caller of parallelFor
+	NODISCARD u32 getWorkerCount() const { return m_WorkerCount; }
+
+	NODISCARD static u32 defaultWorkerCount();
+
+private:
+	void startWorkers();
+
+	void workerLoop();
+
+	//! Takes indices of the current batch until none are left
+	void runJobs(const JobRef &job, u32 count);
+
+	u32 m_WorkerCount = 0; /**< Workers to start */
+	std::vector<std::thread> m_Workers{};
+	std::mutex m_Mutex{};
+	std::condition_variable m_WakeUp{} /**< Signals workers a batch started */, m_Done{} /**< Signals the caller the batch finished */;
+
+	const JobRef *m_Job = nullptr; /**< Job of the current batch */
+	u32 m_Count = 0; /**< Amount of jobs in the current batch */
+	std::atomic<u32> m_Next{0}; /**< Next index to run */
+	u32 m_Active = 0; /**< Workers inside the current batch, the caller waits for them to leave */
+	u64 m_Batch = 0; /**< Batch counter, lets workers tell a new batch from a spurious wake up */
+	bool m_Stop = false;
+};
+
+#endif
@@ -1,20 +1,50 @@
 #include "UUID.h"
 
+#include <atomic>
 #include <random>
 
-#include <unordered_map>
 
+// Threads reserve blocks of the counter, so most ids cost no atomic operation
+static constexpr u64 c_BlockSize = 1024;
+static constexpr u64 c_Gamma = 0x9E3779B97F4A7C15ull;
 
-static std::random_device s_RandomDevice;
-static std::mt19937_64 s_Engine(s_RandomDevice());
-static std::uniform_int_distribution<u64> s_UniformDistribution;
+static std::atomic<u64> s_Seed{std::random_device{}() | (static_cast<u64>(std::random_device{}()) << 32)};
+static std::atomic<u64> s_Counter{0};
+static std::atomic<u32> s_Generation{0};
+
+static thread_local u64 t_Next = 0;
+static thread_local u64 t_End = 0;
+static thread_local u32 t_Generation = ~0u;
+
+//! splitmix64 finalizer, a bijection so distinct counters always give distinct ids
+static u64 mix(u64 z)
+{
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
 
 UUID::UUID()
-		: m_UUID(s_UniformDistribution(s_Engine))
 {
+	// A reseed invalidates every block reserved before it
+	const u32 generation = s_Generation.load(std::memory_order_acquire);
+	if (t_Next == t_End || t_Generation != generation)
+	{
+		t_Next = s_Counter.fetch_add(c_BlockSize, std::memory_order_relaxed);
+		t_End = t_Next + c_BlockSize;
+		t_Generation = generation;
+	}
+	m_UUID = mix(s_Seed.load(std::memory_order_relaxed) + ++t_Next * c_Gamma);
 }
 
 UUID::UUID(u64 uuid)
 		: m_UUID(uuid)
 {
 }
+
+void UUID::seed(u64 seed)
+{
+	s_Seed.store(seed, std::memory_order_relaxed);
+	s_Counter.store(0, std::memory_order_relaxed);
+	s_Generation.fetch_add(1, std::memory_order_release);
+}
@@ -33,6 +33,7 @@ class UUID
 {
 public:
 	//! Default constructor
+	//! Takes the next value of a splitmix64 stream, every id is unique until the seed changes
 	UUID();
 
 	//! Assign constructor
@@ -43,6 +44,13 @@ public:
 	//! @param other UUID to copy from
 	UUID(const UUID &other) = default;
 
+	//! Restarts the generator stream
+	//! The stream is seeded from std::random_device at startup, reseeding with a fixed value
+	//! makes the ids created from a single thread reproducible, for replays. Not meant to be
+	//! called while other threads create ids
+	//! @param seed Start of the stream
+	static void seed(u64 seed);
+
 	//! UUID Operator
 	//! Returns the UUID value as an unsigned 64 bit integer
 	operator u64() const { return m_UUID; }
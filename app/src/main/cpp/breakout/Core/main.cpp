@@ -4,6 +4,9 @@
 #include "FileSystem/FileSystem.h"
 #include "Game.h"
 
+#include <cstring>
+#include <vector>
+
 #include <game-activity/GameActivity.cpp>
 #include <game-text-input/gametextinput.cpp>
 
@@ -11,6 +14,10 @@ extern "C" {
 
 #include <game-activity/native_app_glue/android_native_app_glue.c>
 
+// Game state that outlives the Game, which is destroyed along with the window. Handed to
+// the next Game and to the system when it saves the instance state
+static std::vector<u8> g_SavedState;
+
 /*!
  * Handles commands sent to this Android application
  * @param pApp the app the commands are coming from
@@ -22,7 +29,8 @@ void handle_cmd(android_app *pApp, int32_t cmd) {
             // A new window is created, associate a renderer with it.
             auto game = new Game(pApp);
             pApp->userData = game;
-            game->startGame();
+            game->startGame(g_SavedState);
+            g_SavedState.clear();
 
         }   break;
         case APP_CMD_TERM_WINDOW:
@@ -33,10 +41,31 @@ void handle_cmd(android_app *pApp, int32_t cmd) {
             if (pApp->userData) {
                 //
                 auto *pRenderer = reinterpret_cast<Game *>(pApp->userData);
+                g_SavedState = pRenderer->saveState();
                 pApp->userData = nullptr;
                 delete pRenderer;
             }
             break;
+        case APP_CMD_RESUME:
+            // State saved before the process was killed. The glue frees it once the resume
+            // is handled, the window only comes after that
+            if (pApp->savedState && g_SavedState.empty()) {
+                const auto *state = static_cast<const u8 *>(pApp->savedState);
+                g_SavedState.assign(state, state + pApp->savedStateSize);
+            }
+            break;
+        case APP_CMD_SAVE_STATE:
+            // The glue frees the copy once the system stored it
+            if (pApp->userData) {
+                g_SavedState = reinterpret_cast<Game *>(pApp->userData)->saveState();
+            }
+            if (!g_SavedState.empty()) {
+                free(pApp->savedState);
+                pApp->savedState = malloc(g_SavedState.size());
+                memcpy(pApp->savedState, g_SavedState.data(), g_SavedState.size());
+                pApp->savedStateSize = g_SavedState.size();
+            }
+            break;
         default:
             break;
     }
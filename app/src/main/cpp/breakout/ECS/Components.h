@@ -24,8 +24,11 @@ SOFTWARE.
 
 #pragma once
 
+#include <memory>
 #include <string>
+#include <vector>
 
+#include <Core/StringId.h>
 #include <Core/UUID.h>
 #include <Math/Math.h>
 
@@ -41,14 +44,13 @@ struct IDComponent {
 };
 
 struct TagComponent {
-    std::string Tag;
-
+    StringId Tag;
 
     TagComponent() = default;
 
     TagComponent(const TagComponent &) = default;
 
-    TagComponent(const std::string &tag)
+    TagComponent(StringId tag)
             : Tag(tag) {}
 };
 
@@ -81,8 +83,29 @@ struct TransformComponent {
     }
 };
 
+//! Places an entity relative to a parent
+/*
+* Local is the transform relative to the parent. The hierarchy pass of the scene writes the
+* resulting world transform to the TransformComponent of the entity, so the entity is moved
+* and hidden through Local. Parents are set through Scene::setParent.
+*/
+struct RelationshipComponent {
+    UUID Parent = 0;
+    TransformComponent Local;
+    //! Length of the parent chain, kept by the scene to order the hierarchy pass
+    u32 Depth = 0;
+
+    RelationshipComponent() = default;
+
+    RelationshipComponent(const RelationshipComponent &) = default;
+
+    RelationshipComponent(UUID parent, const TransformComponent &local)
+            : Parent(parent), Local(local) {}
+};
+
 struct SpriteComponent {
     V3 Color = V3{1.0};
+    //! Id returned by Renderer::loadTexture, usually a region of the sprite atlas
     u32 Texture = 0;
 
     SpriteComponent() = default;
@@ -134,14 +157,60 @@ struct TileComponent {
             : Type(type) {}
 };
 
+struct TextRun;
+
+//! Horizontal alignment of the lines of a text
+enum class TextAlign : u8 {
+    LEFT,
+    CENTER,
+    RIGHT
+};
+
+//! Layout parameters of a text, part of the layout cache key
+struct TextStyle {
+    TextAlign Align = TextAlign::LEFT;
+    //! Width lines wrap at, in unscaled text units. 0 only breaks on new lines
+    f32 MaxWidth = 0.0f;
+    //! Distance between baselines, relative to the font line height
+    f32 LineSpacing = 1.0f;
+
+    bool operator==(const TextStyle &other) const {
+        return Align == other.Align && MaxWidth == other.MaxWidth && LineSpacing == other.LineSpacing;
+    }
+};
+
 struct TextComponent{
     std::string Text;
     V3 Color;
+    TextStyle Style;
+
+    //! Shaped glyphs of Text, shared with every text using the same string and style. Fetched
+    //! from the renderer layout cache only when Dirty is set or the font evicted glyphs
+    mutable std::shared_ptr<const TextRun> Layout;
+    mutable bool Dirty = true;
 
     TextComponent() = default;
     TextComponent(const TextComponent&) = default;
     TextComponent(std::string_view text, V3 color)
         : Text(text), Color(color){}
+
+    //! Replaces the text, invalidating the cached layout only if it changed
+    //! @param text New text
+    void setText(std::string_view text) {
+        if (Text != text) {
+            Text.assign(text.data(), text.size());
+            Dirty = true;
+        }
+    }
+
+    //! Replaces the style, invalidating the cached layout only if it changed
+    //! @param style New style
+    void setStyle(const TextStyle &style) {
+        if (!(Style == style)) {
+            Style = style;
+            Dirty = true;
+        }
+    }
 };
 
 template<typename... Component>
@@ -150,4 +219,5 @@ struct ComponentGroup {
 
 using AllComponents
         = ComponentGroup<IDComponent, TagComponent, TransformComponent,
-        SpriteComponent, PlayerComponent, TileComponent, BallComponent, TextComponent>;
+        SpriteComponent, PlayerComponent, TileComponent, BallComponent, TextComponent,
+        RelationshipComponent>;
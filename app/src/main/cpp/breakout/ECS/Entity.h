@@ -79,7 +79,7 @@ public:
 
 	UUID getUuid() { return getComponent<IDComponent>().ID; }
 
-	const std::string &getName() { return getComponent<TagComponent>().Tag; }
+	StringId getName() { return getComponent<TagComponent>().Tag; }
 
 	bool operator==(const Entity &other) const
 	{
@@ -1,13 +1,65 @@
 #include "Scene.h"
 #include "Entity.h"
+#include "Core/AndroidOut.h"
+#include "Memory/MemoryTracker.h"
+
+#include <cassert>
+#include <chrono>
+
+static const StringId s_DefaultName{"Entity"};
+
+//! Tile bookkeeping, lives in the registry context so it follows the registry when moved
+struct TileCounter {
+    std::array<u32, static_cast<size_t>(TileType::MAX)> Counts{};
+    TileDestroyedSignal Destroyed;
+};
+
+// Tile types are fixed on creation, so construction and destruction are enough to keep count
+static void onTileConstruct(SceneRegistry &registry, entt::entity entity) {
+    const auto type = registry.get<TileComponent>(entity).Type;
+    registry.ctx().get<TileCounter>().Counts[static_cast<size_t>(type)]++;
+}
+
+static void onTileDestroy(SceneRegistry &registry, entt::entity entity) {
+    const auto type = registry.get<TileComponent>(entity).Type;
+    auto &counter = registry.ctx().get<TileCounter>();
+    counter.Counts[static_cast<size_t>(type)]--;
+    counter.Destroyed.publish(entity, type);
+}
+
+//! Sweep order of the hierarchy pass, lives in the registry context next to the tile counter
+struct Hierarchy {
+    static constexpr u32 c_Root = ~0u;
+
+    //! Parent of a relationship, by its sweep position when it has a parent itself
+    struct Link {
+        entt::entity Parent = entt::null;
+        u32 ParentIndex = c_Root;
+    };
+
+    //! Parent of each relationship, in sweep order
+    std::vector<Link, PoolAllocator<Link>> Links;
+    //! World transform of each relationship, in sweep order. Children read their parent from
+    //! here, only the roots of the chains are read from the transform storage
+    std::vector<TransformComponent, PoolAllocator<TransformComponent>> World;
+    bool Dirty = false;
+
+    explicit Hierarchy(const PoolAllocator<entt::entity> &allocator)
+            : Links(allocator), World(allocator) {}
+};
+
+// Any attach, detach or reparent invalidates the depths and the sweep order
+static void onRelationshipChanged(SceneRegistry &registry, entt::entity) {
+    registry.ctx().get<Hierarchy>().Dirty = true;
+}
 
 template<typename... Component>
-static void copyComponent(entt::registry &dst, entt::registry &src,
-                          const std::unordered_map<UUID, entt::entity> &enttMap) {
+static void copyComponent(SceneRegistry &dst, SceneRegistry &src,
+                          const UUIDMap &enttMap) {
     ([&]() {
         auto view = src.view<Component>();
         for (auto srcEntity: view) {
-            entt::entity dstEntity = enttMap.at(src.get<IDComponent>(srcEntity).ID);
+            entt::entity dstEntity = enttMap.find(src.get<IDComponent>(srcEntity).ID);
 
             auto &srcComponent = src.get<Component>(srcEntity);
             dst.emplace_or_replace<Component>(dstEntity, srcComponent);
@@ -16,8 +68,8 @@ static void copyComponent(entt::registry &dst, entt::registry &src,
 }
 
 template<typename... Component>
-static void copyComponent(ComponentGroup<Component...>, entt::registry &dst, entt::registry &src,
-                          const std::unordered_map<UUID, entt::entity> &enttMap) {
+static void copyComponent(ComponentGroup<Component...>, SceneRegistry &dst, SceneRegistry &src,
+                          const UUIDMap &enttMap) {
     copyComponent<Component...>(dst, src, enttMap);
 }
 
@@ -33,82 +85,133 @@ template<typename... Component>
 static void copyComponentIfExists(ComponentGroup<Component...>, Entity dst, Entity src) {
     copyComponentIfExists<Component...>(dst, src);
 }
+Scene::Scene() {
+    m_Registry.ctx().emplace<TileCounter>();
+    m_Registry.on_construct<TileComponent>().connect<&onTileConstruct>();
+    m_Registry.on_destroy<TileComponent>().connect<&onTileDestroy>();
+    m_Registry.ctx().emplace<Hierarchy>(m_Registry.get_allocator());
+    m_Registry.on_construct<RelationshipComponent>().connect<&onRelationshipChanged>();
+    m_Registry.on_update<RelationshipComponent>().connect<&onRelationshipChanged>();
+    m_Registry.on_destroy<RelationshipComponent>().connect<&onRelationshipChanged>();
+    if constexpr (SceneStats::isEnabled()) {
+        m_Registry.on_construct<IDComponent>().connect<&SceneStats::onEntityCreated>(*m_Stats);
+        m_Registry.on_destroy<IDComponent>().connect<&SceneStats::onEntityDestroyed>(*m_Stats);
+    }
+
+    // Groups sort their pools as components come and go, creating them up front keeps every
+    // insertion in order and lets const queries find them
+    m_Registry.group<TransformComponent, SpriteComponent>();
+    m_Registry.group<TileComponent>(entt::get<TransformComponent>);
+}
+
 std::shared_ptr<Scene> Scene::copy(Scene& other){
+    MemoryScope memoryScope(MemoryTag::Scene);
+    const auto start = std::chrono::steady_clock::now();
     std::shared_ptr<Scene> newScene = std::make_shared<Scene>();
 
 
     auto& srcSceneRegistry = other.m_Registry;
     auto& dstSceneRegistry = newScene->m_Registry;
-    std::unordered_map<UUID, entt::entity> enttMap;
 
-    // Create entities in new scene
+    // Create entities in new scene, its UUID map doubles as the source to destination map
     auto idView = srcSceneRegistry.view<IDComponent>();
+    newScene->m_Entities.reserve(idView.size());
     for (auto e : idView)
     {
         UUID uuid = srcSceneRegistry.get<IDComponent>(e).ID;
-        const auto& name = srcSceneRegistry.get<TagComponent>(e).Tag;
-        Entity newEntity = newScene->createEntityWithUUID(uuid, name);
-        enttMap[uuid] = (entt::entity)newEntity;
+        const StringId name = srcSceneRegistry.get<TagComponent>(e).Tag;
+        newScene->createEntityWithUUID(uuid, name);
     }
 
     // Copy components (except IDComponent and TagComponent)
-    copyComponent(AllComponents{}, dstSceneRegistry, srcSceneRegistry, enttMap);
+    copyComponent(AllComponents{}, dstSceneRegistry, srcSceneRegistry, newScene->m_Entities);
 
+    if constexpr (SceneStats::isEnabled()) {
+        const std::chrono::duration<f32, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        newScene->m_Stats->recordCopy(elapsed.count());
+    }
     return newScene;
 }
 
 std::shared_ptr<Scene> Scene::copy(std::shared_ptr<Scene> other) {
-    std::shared_ptr<Scene> newScene = std::make_shared<Scene>();
+    return copy(*other);
+}
+Entity Scene::createEntityWithUUID(UUID uuid, StringId name){
+    MemoryScope memoryScope(MemoryTag::Scene);
+    Entity entt = {m_Registry.create(), this};
+    entt.addComponent<IDComponent>(uuid);
+    entt.addComponent<TransformComponent>();
+    entt.addComponent<TagComponent>(name.empty() ? s_DefaultName : name);
 
+    m_Entities.insert(uuid, entt);
+    return entt;
+}
 
-    auto& srcSceneRegistry = other->m_Registry;
-    auto& dstSceneRegistry = newScene->m_Registry;
-    std::unordered_map<UUID, entt::entity> enttMap;
+FrameArena::Vector<entt::entity> Scene::createEntityRange(StringId name, u32 count, const TransformComponent *transforms) {
+    MemoryScope memoryScope(MemoryTag::Scene);
+    auto entities = FrameArena::makeVector<entt::entity>(count);
+    entities.resize(count);
+    m_Registry.create(entities.begin(), entities.end());
 
-    // Create entities in new scene
-    auto idView = srcSceneRegistry.view<IDComponent>();
-    for (auto e : idView)
-    {
-        UUID uuid = srcSceneRegistry.get<IDComponent>(e).ID;
-        const auto& name = srcSceneRegistry.get<TagComponent>(e).Tag;
-        Entity newEntity = newScene->createEntityWithUUID(uuid, name);
-        enttMap[uuid] = (entt::entity)newEntity;
-    }
+    // Default constructed ids draw a new UUID each
+    auto ids = FrameArena::makeVector<IDComponent>(count);
+    ids.resize(count);
+    m_Registry.insert<IDComponent>(entities.begin(), entities.end(), ids.begin());
 
-    // Copy components (except IDComponent and TagComponent)
-    copyComponent(AllComponents{}, dstSceneRegistry, srcSceneRegistry, enttMap);
+    m_Registry.insert<TagComponent>(entities.begin(), entities.end(), TagComponent(name.empty() ? s_DefaultName : name));
+    m_Registry.insert<TransformComponent>(entities.begin(), entities.end(), transforms);
 
-    return newScene;
+    m_Entities.reserve(m_Entities.size() + count);
+    for (u32 i = 0; i < count; i++) {
+        m_Entities.insert(ids[i].ID, entities[i]);
+    }
+    return entities;
 }
-Entity Scene::createEntityWithUUID(UUID uuid, const std::string& name ){
-    Entity entt = {m_Registry.create(), this};
-    entt.addComponent<IDComponent>(uuid);
-    entt.addComponent<TransformComponent>();
-    auto &tag = entt.addComponent<TagComponent>();
-    tag.Tag = name.empty() ? "Entity" : name;
 
-    m_Entities[uuid] = entt;
-    return entt;
+Entity Scene::createEntity(std::string_view name) {
+    return createEntityWithUUID(UUID(), StringId(name));
 }
 
-Entity Scene::createEntity(const std::string &name) {
+Entity Scene::createEntity(StringId name) {
     return createEntityWithUUID(UUID(), name);
 }
 
 void Scene::destroyEntity(Entity entity) {
+    MemoryScope memoryScope(MemoryTag::Scene);
+    // Children go along with their parent, no relationship is left pointing to a dead entity
+    auto &relationships = m_Registry.storage<RelationshipComponent>();
+    if (!relationships.empty()) {
+        const u64 uuid = entity.getUuid();
+        auto children = FrameArena::makeVector<entt::entity>();
+        for (auto [child, relationship]: relationships.each()) {
+            if (relationship.Parent == uuid) {
+                children.push_back(child);
+            }
+        }
+        for (auto child: children) {
+            destroyEntity({child, this});
+        }
+    }
+
     m_Entities.erase(entity.getUuid());
     m_Registry.destroy(entity);
 }
 
 Entity Scene::duplicateEntity(Entity entity) {
-    std::string name = entity.getName();
-    Entity newEntity = createEntity(name);
+    MemoryScope memoryScope(MemoryTag::Scene);
+    Entity newEntity = createEntity(entity.getName());
     copyComponentIfExists(AllComponents{}, newEntity, entity);
     return newEntity;
 }
 
 Entity Scene::findEntityByName(std::string_view name) {
-    auto view = m_Registry.view<TagComponent>();
+    // A string that was never interned can't be the tag of any entity
+    const StringId id = StringId::find(name);
+    return id.empty() ? Entity{} : findEntityByName(id);
+}
+
+Entity Scene::findEntityByName(StringId name) {
+    auto view = getAllEntitiesWith<TagComponent>();
     for (auto entity: view) {
         const TagComponent &tc = view.get<TagComponent>(entity);
         if (tc.Tag == name)
@@ -118,9 +221,142 @@ Entity Scene::findEntityByName(std::string_view name) {
 }
 
 Entity Scene::getEntityByUuid(UUID uuid) {
-    if (m_Entities.find(uuid) != m_Entities.end()) {
-        return {m_Entities.at(uuid), this};
+    const entt::entity entity = m_Entities.find(uuid);
+    if (entity != entt::null) {
+        return {entity, this};
     }
 
     return {};
 }
+
+bool Scene::setParent(Entity child, Entity parent) {
+    MemoryScope memoryScope(MemoryTag::Scene);
+    for (Entity ancestor = parent; ancestor; ancestor = getParent(ancestor)) {
+        if (ancestor == child) {
+            aout << "Error: Can't parent " << child.getName().str() << " to its own descendant "
+                 << parent.getName().str() << std::endl;
+            return false;
+        }
+    }
+
+    const auto &transform = m_Registry.get<TransformComponent>(child);
+    m_Registry.emplace_or_replace<RelationshipComponent>(child, parent.getUuid(), transform);
+    return true;
+}
+
+void Scene::removeParent(Entity child) {
+    m_Registry.remove<RelationshipComponent>(child);
+}
+
+Entity Scene::getParent(Entity child) {
+    const auto *relationship = m_Registry.try_get<RelationshipComponent>(child);
+    return relationship ? getEntityByUuid(relationship->Parent) : Entity{};
+}
+
+void Scene::sortHierarchy() {
+    auto &hierarchy = m_Registry.ctx().get<Hierarchy>();
+    auto &relationships = m_Registry.storage<RelationshipComponent>();
+
+    // setParent keeps the chains free of cycles
+    for (auto [entity, relationship]: relationships.each()) {
+        u32 depth = 0;
+        for (entt::entity parent = m_Entities.find(relationship.Parent);
+             parent != entt::null && relationships.contains(parent);
+             parent = m_Entities.find(relationships.get(parent).Parent)) {
+            depth++;
+        }
+        relationship.Depth = depth;
+    }
+    m_Registry.sort<RelationshipComponent>([](const RelationshipComponent &lhs, const RelationshipComponent &rhs) {
+        return lhs.Depth < rhs.Depth;
+    });
+
+    // Parents are resolved once here instead of on every sweep. Storages iterate their packed
+    // array backwards, the sweep position of an entity is its index counted from the end
+    const u32 count = static_cast<u32>(relationships.size());
+    hierarchy.Links.clear();
+    hierarchy.Links.reserve(count);
+    for (auto [entity, relationship]: relationships.each()) {
+        Hierarchy::Link link;
+        link.Parent = m_Entities.find(relationship.Parent);
+        if (link.Parent != entt::null && relationships.contains(link.Parent)) {
+            link.ParentIndex = count - 1 - static_cast<u32>(relationships.index(link.Parent));
+            assert(link.ParentIndex < hierarchy.Links.size());
+        }
+        hierarchy.Links.push_back(link);
+    }
+    hierarchy.World.resize(count);
+    hierarchy.Dirty = false;
+}
+
+void Scene::updateTransforms() {
+    auto &relationships = m_Registry.storage<RelationshipComponent>();
+    if (relationships.empty()) {
+        return;
+    }
+
+    auto &hierarchy = m_Registry.ctx().get<Hierarchy>();
+    if (hierarchy.Dirty) {
+        sortHierarchy();
+    }
+
+    // The transform storage is owned by the renderables group and can't follow the sweep order,
+    // so each result is still copied back to it for the renderer and physics
+    auto &transforms = m_Registry.storage<TransformComponent>();
+    u32 index = 0;
+    for (auto [entity, relationship]: relationships.each()) {
+        const auto &link = hierarchy.Links[index];
+        const auto &local = relationship.Local;
+        auto &world = hierarchy.World[index];
+        if (link.Parent == entt::null) {
+            world = local;
+        } else {
+            const auto &parentWorld = link.ParentIndex != Hierarchy::c_Root
+                                      ? hierarchy.World[link.ParentIndex]
+                                      : transforms.get(link.Parent);
+            world.Translation = parentWorld.Translation + parentWorld.Rotation * (parentWorld.Scale * local.Translation);
+            world.Rotation = parentWorld.Rotation * local.Rotation;
+            world.Scale = parentWorld.Scale * local.Scale;
+            world.Enabled = parentWorld.Enabled && local.Enabled;
+        }
+        transforms.get(entity) = world;
+        index++;
+    }
+}
+
+u32 Scene::getTileCount(TileType type) const {
+    return m_Registry.ctx().get<TileCounter>().Counts[static_cast<size_t>(type)];
+}
+
+entt::sink<TileDestroyedSignal> Scene::onTileDestroyed() {
+    return entt::sink{m_Registry.ctx().get<TileCounter>().Destroyed};
+}
+
+std::vector<SceneStats::StorageStats> Scene::getStorageStats() const {
+    std::vector<SceneStats::StorageStats> storages;
+    for (auto [id, storage]: m_Registry.storage()) {
+        storages.push_back({storage.type().name(), storage.size(), storage.capacity()});
+    }
+    return storages;
+}
+
+void Scene::endFrame() {
+    if constexpr (SceneStats::isEnabled()) {
+        m_Stats->endFrame();
+    }
+}
+
+void Scene::dumpStats(std::string_view label) const {
+    if constexpr (SceneStats::isEnabled()) {
+        m_Stats->dump(label, getStorageStats());
+    }
+}
+
+void Scene::traceStats(std::string_view label) const {
+    if constexpr (SceneStats::isEnabled()) {
+        // Listing the storages allocates, skip it on frames nobody records
+        if (SceneStats::isTracing()) {
+            m_Stats->trace(label, getStorageStats());
+        }
+    }
+}
@@ -28,9 +28,22 @@ SOFTWARE.
 #include <Common.h>
 #include <Entt/entt.hpp>
 #include "Components.h"
+#include "SceneStats.h"
+#include "UUIDMap.h"
+#include <Memory/FrameArena.h>
+#include <Memory/MemoryPool.h>
+
+#include <array>
 
 
 class Entity;
+
+//! Registry of a scene, every storage is drawn from the scene memory pool
+using SceneRegistry = entt::basic_registry<entt::entity, PoolAllocator<entt::entity>>;
+
+//! Signal published when a tile is destroyed
+using TileDestroyedSignal = entt::sigh<void(entt::entity, TileType)>;
+
 //! Scene class
 /*
 * Holds all the entities and manages them
@@ -39,7 +52,8 @@ class Scene
 {
 public:
 	//! Default constructor
-	Scene() = default;
+	//! Hooks the tile observers and creates the hot path groups
+	Scene();
 
 	//! Default destructor
 	~Scene() = default;
@@ -48,18 +62,45 @@ public:
     static std::shared_ptr<Scene> copy(Scene& other);
     static std::shared_ptr<Scene> copy(std::shared_ptr<Scene> other);
 
-	DEFAULT_MOVE_AND_COPY(Scene)
+	//! Move constructor, the storages keep pointing to the pool that moves along
+	Scene(Scene &&other) noexcept = default;
+
+	//! entt can't move storages between registries of different pools
+	Scene &operator=(Scene &&other) = delete;
+
+	DISABLE_COPY(Scene)
 
 	//! Entity creation function
 	//! @param name Name of the created entity
 	//! @return The created entity
-	Entity createEntity(const std::string &name);
+	Entity createEntity(std::string_view name);
+
+	//! Entity creation function
+	//! @param name Interned name of the created entity
+	//! @return The created entity
+	Entity createEntity(StringId name);
 
     //! Entity creation function
     //! @param uuid UUID of the created entity
-    //! @param name Name of the created entity
+    //! @param name Interned name of the created entity, "Entity" if empty
     //! @return The created entity
-    Entity createEntityWithUUID(UUID uuid, const std::string& name = std::string());
+    Entity createEntityWithUUID(UUID uuid, StringId name = {});
+
+	//! Bulk entity creation function
+	//! Creates every entity in one pass, each component type is inserted with a single range
+	//! insert into its reserved storage
+	//! @param name Name of every created entity
+	//! @param count Amount of entities to create
+	//! @param transforms Transform of each entity
+	//! @param components One array per extra component type, with the component of each entity
+	template<typename... Components>
+	void createEntities(StringId name, u32 count, const TransformComponent *transforms,
+	                    const Components *... components)
+	{
+		(m_Registry.storage<Components>().reserve(m_Registry.storage<Components>().size() + count), ...);
+		const auto entities = createEntityRange(name, count, transforms);
+		(m_Registry.insert<Components>(entities.begin(), entities.end(), components), ...);
+	}
 
 	//! Entity destruction function
 	//! @param entity The entity being destroyed
@@ -75,23 +116,130 @@ public:
 	//! @return Entity found on the search
 	Entity findEntityByName(std::string_view name);
 
+	//! Finds an entity with the specified interned name, comparing ids only
+	//! @param name Interned identifier of the entity
+	//! @return Entity found on the search
+	Entity findEntityByName(StringId name);
+
     //! Finds an entity with an specific UUID
     //! @param uuid The uuid to search
     //! @return The found entity
 	Entity getEntityByUuid(UUID uuid);
 
+	//! Attaches an entity to a parent, its current transform becomes relative to the parent
+	//! @param child Entity to attach
+	//! @param parent New parent, can't be the entity or one of its descendants
+	//! @return If the entity was attached
+	bool setParent(Entity child, Entity parent);
+
+	//! Detaches an entity from its parent, it stays where the last hierarchy pass placed it
+	//! @param child Entity to detach
+	void removeParent(Entity child);
+
+	//! Finds the parent of an entity
+	//! @param child Entity to query
+	//! @return The parent, null if the entity has none
+	Entity getParent(Entity child);
+
+	//! Hierarchy pass, writes the world transform of every entity with a parent
+	//! Relationships are kept sorted by depth, so every parent is placed before its children
+	//! in a single sweep over the relationship storage. The order is only rebuilt after the
+	//! hierarchy changes
+	void updateTransforms();
+
+	//! Live tile count, kept up to date on tile construction and destruction
+	//! @param type Type of the tiles to count
+	//! @return Amount of tiles of the given type in the scene
+	NODISCARD u32 getTileCount(TileType type) const;
+
+	//! Sink to subscribe to tile destruction
+	//! @return The sink of the tile destroyed signal
+	entt::sink<TileDestroyedSignal> onTileDestroyed();
+
 	//! Templated function for all the entities with the components given
 	//! @return A view of all the entities with the given components
 	template<typename... Components>
 	auto getAllEntitiesWith() const
 	{
-		return m_Registry.view<Components...>();
+		auto view = m_Registry.view<Components...>();
+		if constexpr (SceneStats::isEnabled())
+		{
+			// Single component views know their exact size, the rest only their smallest pool
+			size_t entities = 0;
+			if constexpr (sizeof...(Components) == 1)
+			{
+				entities = view.size();
+			}
+			else
+			{
+				entities = view.size_hint();
+			}
+			using Query = entt::type_list<Components...>;
+			m_Stats->recordQuery(entt::type_hash<Query>::value(), entt::type_name<Query>::value(), entities);
+		}
+		return view;
+	}
+
+	//! Hot query of the renderer, owns both components so they are packed in iteration order
+	//! @return A group of all the entities with a transform and a sprite
+	auto getRenderables() const
+	{
+		auto group = m_Registry.group_if_exists<TransformComponent, SpriteComponent>();
+		if constexpr (SceneStats::isEnabled())
+		{
+			m_Stats->recordQuery(entt::hashed_string::value("Renderables"), "Renderables", group.size());
+		}
+		return group;
+	}
+
+	//! Hot query of the collision pass, only owns the tiles as the transforms are taken by the renderables
+	//! @return A group of all the entities with a tile and a transform
+	auto getColliders()
+	{
+		auto group = m_Registry.group<TileComponent>(entt::get<TransformComponent>);
+		if constexpr (SceneStats::isEnabled())
+		{
+			m_Stats->recordQuery(entt::hashed_string::value("Colliders"), "Colliders", group.size());
+		}
+		return group;
 	}
 
+	//! Debug counters of the scene
+	//! @return The counters, null unless built with BREAKOUT_ECS_STATS
+	NODISCARD const SceneStats *getStats() const { return m_Stats.get(); }
+
+	//! Sizes of every component storage, available on every build
+	//! @return One entry per storage created in the registry
+	NODISCARD std::vector<SceneStats::StorageStats> getStorageStats() const;
+
+	//! Closes the per frame counters of the scene, see getStats
+	void endFrame();
+
+	//! Logs the last frame counters and the storage sizes, only with BREAKOUT_ECS_STATS
+	//! @param label Name of the scene in the log
+	void dumpStats(std::string_view label) const;
+
+	//! Publishes the last frame counters and the storage sizes as profiler counters
+	//! Does nothing unless built with BREAKOUT_ECS_STATS and a system trace is being recorded
+	//! @param label Prefix of the counter names
+	void traceStats(std::string_view label) const;
+
 private:
-	entt::registry m_Registry; /**< Scene entity registry */
-	std::unordered_map<UUID, entt::entity> m_Entities{}; /**< Registered entities map */
+	//! Creates count entities with their id, tag and transform
+	//! @return The created entities, valid until the end of the frame
+	FrameArena::Vector<entt::entity> createEntityRange(StringId name, u32 count, const TransformComponent *transforms);
+
+	//! Recomputes the depth of every relationship and sorts the storage by it
+	void sortHierarchy();
+
+	// The pool is declared first so it outlives the registry storages allocated from it
+	std::unique_ptr<MemoryPool> m_Pool = std::make_unique<MemoryPool>(); /**< Scene storage pool, freed with the scene */
+	SceneRegistry m_Registry{PoolAllocator<entt::entity>(*m_Pool)}; /**< Scene entity registry */
+	UUIDMap m_Entities{}; /**< Registered entities map */
+	std::unique_ptr<SceneStats> m_Stats = SceneStats::isEnabled() ? std::make_unique<SceneStats>() : nullptr; /**< Debug counters, null when disabled */
 
 	friend class Entity;
+	friend class SceneSerializer;
+	friend class SystemScheduler;
 };
 
@@ -0,0 +1,423 @@
+#include "SceneSerializer.h"
+#include "Scene.h"
+#include "Core/AndroidOut.h"
+#include "Memory/MemoryTracker.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+namespace {
+    class Writer {
+    public:
+        template<typename T>
+        void write(const T &value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            const auto *bytes = reinterpret_cast<const u8 *>(&value);
+            m_Data.insert(m_Data.end(), bytes, bytes + sizeof(T));
+        }
+
+        void write(std::string_view string) {
+            write(static_cast<u32>(string.size()));
+            m_Data.insert(m_Data.end(), string.begin(), string.end());
+        }
+
+        std::vector<u8> &getData() { return m_Data; }
+
+    private:
+        std::vector<u8> m_Data;
+    };
+
+    class Reader {
+    public:
+        Reader(const u8 *data, size_t size) : m_Data(data), m_Size(size) {}
+
+        template<typename T>
+        void read(T &value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            if (!require(sizeof(T))) {
+                return;
+            }
+            std::memcpy(&value, m_Data + m_Offset, sizeof(T));
+            m_Offset += sizeof(T);
+        }
+
+        void read(std::string &string) {
+            u32 size = 0;
+            read(size);
+            if (!require(size)) {
+                return;
+            }
+            string.assign(reinterpret_cast<const char *>(m_Data + m_Offset), size);
+            m_Offset += size;
+        }
+
+        //! Checks that at least count elements of the given size are left, so corrupt counts
+        //! fail before anything is allocated for them
+        bool require(size_t count, size_t elementSize = 1) {
+            if (m_Failed || count > (m_Size - m_Offset) / elementSize) {
+                m_Failed = true;
+            }
+            return !m_Failed;
+        }
+
+        void fail() { m_Failed = true; }
+
+        bool failed() const { return m_Failed; }
+
+    private:
+        const u8 *m_Data;
+        size_t m_Size;
+        size_t m_Offset = 0;
+        bool m_Failed = false;
+    };
+
+    //! Tags and texts repeat a lot, each distinct string is stored once
+    class StringTable {
+    public:
+        u32 intern(std::string_view string) {
+            const auto [it, inserted] = m_Indices.try_emplace(string, static_cast<u32>(m_Strings.size()));
+            if (inserted) {
+                m_Strings.push_back(string);
+            }
+            return it->second;
+        }
+
+        const std::vector<std::string_view> &getStrings() const { return m_Strings; }
+
+    private:
+        std::vector<std::string_view> m_Strings;
+        std::unordered_map<std::string_view, u32> m_Indices;
+    };
+
+    struct LoadContext {
+        Reader &In;
+        SceneRegistry &Registry;
+        const std::vector<entt::entity> &Entities;
+        const std::vector<std::string> &Strings;
+        //! Entities already given a component by the current block
+        std::vector<bool> Seen;
+        //! Component types already read, each type has a single block
+        std::vector<bool> Loaded;
+    };
+
+    // Component codecs, fields are written one by one so padding never reaches the format
+
+    void encode(Writer &out, StringTable &, const TransformComponent &transform) {
+        out.write(transform.Translation);
+        out.write(V4{transform.Rotation.w, transform.Rotation.x, transform.Rotation.y, transform.Rotation.z});
+        out.write(transform.Scale);
+        out.write(static_cast<u8>(transform.Enabled));
+    }
+
+    void decode(LoadContext &ctx, TransformComponent &transform) {
+        V4 rotation{};
+        u8 enabled = 0;
+        ctx.In.read(transform.Translation);
+        ctx.In.read(rotation);
+        ctx.In.read(transform.Scale);
+        ctx.In.read(enabled);
+        transform.Rotation = Quaternion{rotation.x, rotation.y, rotation.z, rotation.w};
+        transform.Enabled = enabled != 0;
+    }
+
+    void encode(Writer &out, StringTable &, const SpriteComponent &sprite) {
+        out.write(sprite.Color);
+        out.write(sprite.Texture);
+    }
+
+    void decode(LoadContext &ctx, SpriteComponent &sprite) {
+        ctx.In.read(sprite.Color);
+        ctx.In.read(sprite.Texture);
+    }
+
+    void encode(Writer &out, StringTable &, const PlayerComponent &player) {
+        out.write(player.Lives);
+        out.write(player.Speed);
+    }
+
+    void decode(LoadContext &ctx, PlayerComponent &player) {
+        ctx.In.read(player.Lives);
+        ctx.In.read(player.Speed);
+    }
+
+    void encode(Writer &out, StringTable &, const TileComponent &tile) {
+        out.write(static_cast<u8>(tile.Type));
+    }
+
+    void decode(LoadContext &ctx, TileComponent &tile) {
+        u8 type = 0;
+        ctx.In.read(type);
+        if (type >= static_cast<u8>(TileType::MAX)) {
+            ctx.In.fail();
+            return;
+        }
+        tile.Type = static_cast<TileType>(type);
+    }
+
+    void encode(Writer &out, StringTable &, const BallComponent &ball) {
+        out.write(ball.Speed);
+        out.write(ball.Radius);
+    }
+
+    void decode(LoadContext &ctx, BallComponent &ball) {
+        ctx.In.read(ball.Speed);
+        ctx.In.read(ball.Radius);
+    }
+
+    void encode(Writer &out, StringTable &strings, const TextComponent &text) {
+        out.write(strings.intern(text.Text));
+        out.write(text.Color);
+        out.write(static_cast<u8>(text.Style.Align));
+        out.write(text.Style.MaxWidth);
+        out.write(text.Style.LineSpacing);
+    }
+
+    void decode(LoadContext &ctx, TextComponent &text) {
+        u32 string = 0;
+        u8 align = 0;
+        ctx.In.read(string);
+        ctx.In.read(text.Color);
+        ctx.In.read(align);
+        ctx.In.read(text.Style.MaxWidth);
+        ctx.In.read(text.Style.LineSpacing);
+        if (string >= ctx.Strings.size() || align > static_cast<u8>(TextAlign::RIGHT)) {
+            ctx.In.fail();
+            return;
+        }
+        text.Text = ctx.Strings[string];
+        text.Style.Align = static_cast<TextAlign>(align);
+    }
+
+    // Depths are derived, the scene recomputes them on the first hierarchy pass
+    void encode(Writer &out, StringTable &strings, const RelationshipComponent &relationship) {
+        out.write(static_cast<u64>(relationship.Parent));
+        encode(out, strings, relationship.Local);
+    }
+
+    void decode(LoadContext &ctx, RelationshipComponent &relationship) {
+        u64 parent = 0;
+        ctx.In.read(parent);
+        relationship.Parent = parent;
+        decode(ctx, relationship.Local);
+    }
+
+    //! Ids and tags live in the entity table, the rest are written as blocks
+    template<typename Component>
+    constexpr bool c_IsBlock = !std::is_same_v<Component, IDComponent> && !std::is_same_v<Component, TagComponent>;
+
+    template<typename... Component>
+    constexpr u32 countComponents(ComponentGroup<Component...>) {
+        return sizeof...(Component);
+    }
+
+    constexpr u32 c_ComponentTypeCount = countComponents(AllComponents{});
+
+    template<typename Component>
+    void writeBlock(Writer &out, StringTable &strings, u32 type, const SceneRegistry &registry,
+                    const std::vector<entt::entity> &entities) {
+        auto view = registry.view<Component>();
+        std::vector<u32> indices;
+        for (u32 i = 0; i < entities.size(); i++) {
+            if (view.contains(entities[i])) {
+                indices.push_back(i);
+            }
+        }
+        if (indices.empty()) {
+            return;
+        }
+
+        out.write(type);
+        out.write(static_cast<u32>(indices.size()));
+        for (u32 index: indices) {
+            out.write(index);
+        }
+        for (u32 index: indices) {
+            encode(out, strings, view.template get<Component>(entities[index]));
+        }
+    }
+
+    template<typename... Component>
+    void writeBlocks(ComponentGroup<Component...>, Writer &out, StringTable &strings,
+                     const SceneRegistry &registry, const std::vector<entt::entity> &entities) {
+        u32 type = 0;
+        ([&]() {
+            if constexpr (c_IsBlock<Component>) {
+                writeBlock<Component>(out, strings, type, registry, entities);
+            }
+            type++;
+        }(), ...);
+    }
+
+    template<typename Component>
+    bool readBlock(LoadContext &ctx) {
+        u32 count = 0;
+        ctx.In.read(count);
+        if (!ctx.In.require(count, sizeof(u32))) {
+            return false;
+        }
+
+        // A repeated index would emplace the component twice
+        ctx.Seen.assign(ctx.Entities.size(), false);
+        std::vector<entt::entity> targets(count);
+        for (auto &target: targets) {
+            u32 index = 0;
+            ctx.In.read(index);
+            if (index >= ctx.Entities.size() || ctx.Seen[index]) {
+                return false;
+            }
+            ctx.Seen[index] = true;
+            target = ctx.Entities[index];
+        }
+
+        std::vector<Component> components(count);
+        for (auto &component: components) {
+            decode(ctx, component);
+        }
+        if (ctx.In.failed()) {
+            return false;
+        }
+
+        ctx.Registry.insert<Component>(targets.begin(), targets.end(), components.begin());
+        return true;
+    }
+
+    template<typename... Component>
+    bool readBlock(ComponentGroup<Component...>, u32 type, LoadContext &ctx) {
+        u32 index = 0;
+        bool loaded = false;
+        ([&]() {
+            if constexpr (c_IsBlock<Component>) {
+                if (index == type && !ctx.Loaded[index]) {
+                    ctx.Loaded[index] = true;
+                    loaded = readBlock<Component>(ctx);
+                }
+            }
+            index++;
+        }(), ...);
+        return loaded;
+    }
+}
+
+std::vector<u8> SceneSerializer::serialize(const Scene &scene) {
+    const auto &registry = scene.m_Registry;
+    const auto ids = registry.view<IDComponent>();
+
+    std::vector<entt::entity> entities(ids.begin(), ids.end());
+    std::sort(entities.begin(), entities.end(), [&ids](entt::entity a, entt::entity b) {
+        return static_cast<u64>(ids.get<IDComponent>(a).ID) < static_cast<u64>(ids.get<IDComponent>(b).ID);
+    });
+
+    // Components go first so every string is interned by the time the table is written
+    Writer body;
+    StringTable strings;
+    std::vector<u32> tags;
+    tags.reserve(entities.size());
+    for (auto entity: entities) {
+        tags.push_back(strings.intern(registry.get<TagComponent>(entity).Tag.str()));
+    }
+    writeBlocks(AllComponents{}, body, strings, registry, entities);
+
+    Writer out;
+    out.write(c_Magic);
+    out.write(c_Version);
+    out.write(static_cast<u32>(entities.size()));
+    out.write(static_cast<u32>(strings.getStrings().size()));
+    for (auto string: strings.getStrings()) {
+        out.write(string);
+    }
+    for (auto entity: entities) {
+        out.write(static_cast<u64>(ids.get<IDComponent>(entity).ID));
+    }
+    for (u32 tag: tags) {
+        out.write(tag);
+    }
+
+    auto &data = out.getData();
+    data.insert(data.end(), body.getData().begin(), body.getData().end());
+    return std::move(data);
+}
+
+std::shared_ptr<Scene> SceneSerializer::deserialize(const u8 *data, size_t size) {
+    MemoryScope memoryScope(MemoryTag::Scene);
+    Reader in(data, size);
+
+    u32 magic = 0;
+    u32 version = 0;
+    u32 entityCount = 0;
+    u32 stringCount = 0;
+    in.read(magic);
+    in.read(version);
+    in.read(entityCount);
+    in.read(stringCount);
+    if (in.failed() || magic != c_Magic || version != c_Version) {
+        aout << "Error: Scene data has no valid header or an unsupported version" << std::endl;
+        return nullptr;
+    }
+
+    std::vector<std::string> strings;
+    if (in.require(stringCount, sizeof(u32))) {
+        strings.resize(stringCount);
+        for (auto &string: strings) {
+            in.read(string);
+        }
+    }
+
+    std::vector<IDComponent> ids;
+    std::vector<TagComponent> tags;
+    if (in.require(entityCount, sizeof(u64) + sizeof(u32))) {
+        ids.resize(entityCount);
+        tags.resize(entityCount);
+        for (auto &id: ids) {
+            u64 uuid = 0;
+            in.read(uuid);
+            id.ID = uuid;
+        }
+        for (auto &tag: tags) {
+            u32 index = 0;
+            in.read(index);
+            if (index >= strings.size()) {
+                in.fail();
+                break;
+            }
+            tag.Tag = StringId(strings[index]);
+        }
+    }
+    if (in.failed()) {
+        aout << "Error: Scene data is truncated" << std::endl;
+        return nullptr;
+    }
+
+    auto scene = std::make_shared<Scene>();
+    auto &registry = scene->m_Registry;
+
+    std::vector<entt::entity> entities(entityCount);
+    registry.create(entities.begin(), entities.end());
+
+    // A repeated id would map two entities to the same UUID
+    scene->m_Entities.reserve(entityCount);
+    for (u32 i = 0; i < entityCount; i++) {
+        if (scene->m_Entities.find(ids[i].ID) != entt::null) {
+            aout << "Error: Scene data has a repeated entity id" << std::endl;
+            return nullptr;
+        }
+        scene->m_Entities.insert(ids[i].ID, entities[i]);
+    }
+    registry.insert<IDComponent>(entities.begin(), entities.end(), ids.begin());
+    registry.insert<TagComponent>(entities.begin(), entities.end(), tags.begin());
+
+    LoadContext ctx{in, registry, entities, strings};
+    ctx.Loaded.resize(c_ComponentTypeCount);
+    while (!in.failed() && in.require(1)) {
+        u32 type = 0;
+        in.read(type);
+        if (!readBlock(AllComponents{}, type, ctx)) {
+            aout << "Error: Scene data has an invalid component block" << std::endl;
+            return nullptr;
+        }
+    }
+
+    return scene;
+}
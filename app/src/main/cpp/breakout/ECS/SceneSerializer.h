@@ -0,0 +1,67 @@
+/*
+MIT License
+
+Copyright (c) 2023 Victor Falcon Zaro
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <Common.h>
+#include <memory>
+#include <vector>
+
+class Scene;
+
+//! Binary scene format
+/*
+* Layout, little endian:
+*	header        magic, version, entity count, string count
+*	string table  length prefixed strings, tags and texts are interned here
+*	entity table  UUIDs and tag string indices, sorted by UUID
+*	blocks        per component type: type index, count, entity indices, packed components
+*
+* Entities are written sorted by UUID so equal scenes produce equal bytes, two saves
+* can be diffed directly. Sprite textures are stored as renderer ids, which only stay
+* valid while the textures are loaded in the same order.
+*/
+class SceneSerializer
+{
+public:
+	static constexpr u32 c_Magic = 0x43534B42; // "BKSC"
+	static constexpr u32 c_Version = 2; // 2 added the relationship block
+
+	//! Serializes every entity of the scene with all the components in AllComponents
+	//! @param scene Scene to serialize
+	//! @return The serialized scene
+	NODISCARD static std::vector<u8> serialize(const Scene &scene);
+
+	//! Creates a scene from serialized data, components are bulk inserted per type
+	//! @param data Serialized scene
+	//! @param size Size of the data in bytes
+	//! @return The loaded scene, nullptr if the data is not a valid scene of this version
+	NODISCARD static std::shared_ptr<Scene> deserialize(const u8 *data, size_t size);
+
+	//! @see deserialize(const u8 *, size_t)
+	NODISCARD static std::shared_ptr<Scene> deserialize(const std::vector<u8> &data)
+	{
+		return deserialize(data.data(), data.size());
+	}
+};
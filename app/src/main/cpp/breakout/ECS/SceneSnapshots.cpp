@@ -0,0 +1,198 @@
+#include "SceneSnapshots.h"
+#include "Scene.h"
+#include "Entity.h"
+
+#include <algorithm>
+
+void SceneSnapshots::setAlive(std::vector<u64> &bits, u32 index, bool alive) {
+    const u64 mask = u64(1) << (index % 64);
+    bits[index / 64] = alive ? bits[index / 64] | mask : bits[index / 64] & ~mask;
+}
+
+void SceneSnapshots::reset(Scene &scene) {
+    m_Tiles.clear();
+    for (auto entity: scene.getColliders()) {
+        Entity tile{entity, &scene};
+        m_Tiles.push_back({tile.getUuid(), tile.getName(), tile.getComponent<TransformComponent>(),
+                           tile.getComponent<TileComponent>(),
+                           tile.hasComponent<SpriteComponent>() ? tile.getComponent<SpriteComponent>() : SpriteComponent()});
+    }
+
+    m_DynamicIds.clear();
+    const auto addDynamic = [this, &scene](entt::entity entity) {
+        if (m_DynamicIds.size() < c_MaxDynamicEntities) {
+            m_DynamicIds.push_back(Entity{entity, &scene}.getUuid());
+        }
+    };
+    for (auto entity: scene.getAllEntitiesWith<PlayerComponent>()) {
+        addDynamic(entity);
+    }
+    for (auto entity: scene.getAllEntitiesWith<BallComponent>()) {
+        addDynamic(entity);
+    }
+
+    // Every buffer is sized here so capturing never allocates
+    const size_t words = (m_Tiles.size() + 63) / 64;
+    m_Alive.assign(words, 0);
+    for (u32 i = 0; i < m_Tiles.size(); i++) {
+        setAlive(m_Alive, i, true);
+    }
+    m_AliveCount = static_cast<u32>(m_Tiles.size());
+    m_Target.assign(words, 0);
+    m_Removed.clear();
+    m_Removed.reserve(m_Tiles.size());
+    for (auto &keyframe: m_Keyframes) {
+        keyframe.Tick = ~0u;
+        keyframe.Alive.assign(words, 0);
+    }
+
+    m_NextKeyframe = 0;
+    m_Tick = 0;
+    m_First = 0;
+    m_LastKeyframe = 0;
+}
+
+bool SceneSnapshots::syncAlive(Scene &scene) {
+    m_Removed.clear();
+
+    // Tiles are counted on destruction, the scan only runs on ticks that lost some
+    u32 count = 0;
+    for (u32 type = 0; type < static_cast<u32>(TileType::MAX); type++) {
+        count += scene.getTileCount(static_cast<TileType>(type));
+    }
+    if (count == m_AliveCount) {
+        return false;
+    }
+
+    for (u32 i = 0; i < m_Tiles.size(); i++) {
+        if (isAlive(m_Alive, i) && !scene.getEntityByUuid(m_Tiles[i].Id)) {
+            setAlive(m_Alive, i, false);
+            m_Removed.push_back(i);
+        }
+    }
+    m_AliveCount = count;
+    return !m_Removed.empty();
+}
+
+void SceneSnapshots::capture(Scene &scene, const SnapshotCounters &counters) {
+    syncAlive(scene);
+
+    if (m_Tick - m_First >= c_Capacity) {
+        m_First = m_Tick - c_Capacity + 1;
+    }
+
+    Snapshot &snapshot = m_Snapshots[m_Tick % c_Capacity];
+    snapshot.Tick = m_Tick;
+    snapshot.AliveCount = m_AliveCount;
+    snapshot.Counters = counters;
+    for (u32 i = 0; i < m_DynamicIds.size(); i++) {
+        auto &state = snapshot.Dynamic[i];
+        Entity entity = scene.getEntityByUuid(m_DynamicIds[i]);
+        state.Id = m_DynamicIds[i];
+        if (entity) {
+            state.Transform = entity.getComponent<TransformComponent>();
+            state.Ball = entity.hasComponent<BallComponent>() ? entity.getComponent<BallComponent>() : BallComponent();
+        }
+    }
+
+    const bool keyframe = m_Tick == 0 || m_Tick - m_LastKeyframe >= c_KeyframeInterval
+                          || m_Removed.size() > c_MaxRemovals;
+    if (keyframe) {
+        auto &slot = m_Keyframes[m_NextKeyframe++ % m_Keyframes.size()];
+        slot.Tick = m_Tick;
+        std::copy(m_Alive.begin(), m_Alive.end(), slot.Alive.begin());
+        m_LastKeyframe = m_Tick;
+        snapshot.RemovedCount = 0;
+    } else {
+        std::copy(m_Removed.begin(), m_Removed.end(), snapshot.Removed.begin());
+        snapshot.RemovedCount = static_cast<u32>(m_Removed.size());
+    }
+    snapshot.Keyframe = m_LastKeyframe;
+
+    m_Tick++;
+}
+
+bool SceneSnapshots::buildTarget(const Snapshot &snapshot) {
+    // The removals after the keyframe must all still be in the ring
+    if (snapshot.Keyframe + 1 < m_First) {
+        return false;
+    }
+
+    const auto keyframe = std::find_if(m_Keyframes.begin(), m_Keyframes.end(), [&snapshot](const Keyframe &k) {
+        return k.Tick == snapshot.Keyframe;
+    });
+    if (keyframe == m_Keyframes.end()) {
+        return false;
+    }
+
+    std::copy(keyframe->Alive.begin(), keyframe->Alive.end(), m_Target.begin());
+    for (u32 tick = snapshot.Keyframe + 1; tick <= snapshot.Tick; tick++) {
+        const Snapshot &delta = m_Snapshots[tick % c_Capacity];
+        for (u32 i = 0; i < delta.RemovedCount; i++) {
+            setAlive(m_Target, delta.Removed[i], false);
+        }
+    }
+    return true;
+}
+
+bool SceneSnapshots::restore(Scene &scene, u32 ticksAgo, SnapshotCounters &counters) {
+    if (ticksAgo >= m_Tick - m_First) {
+        return false;
+    }
+
+    const Snapshot &snapshot = m_Snapshots[(m_Tick - 1 - ticksAgo) % c_Capacity];
+    if (!buildTarget(snapshot)) {
+        return false;
+    }
+
+    // Catch up with tiles destroyed after the last capture, then only touch the tiles that differ
+    syncAlive(scene);
+    for (u32 word = 0; word < m_Alive.size(); word++) {
+        for (u64 diff = m_Alive[word] ^ m_Target[word]; diff; diff &= diff - 1) {
+            const u32 index = word * 64 + static_cast<u32>(__builtin_ctzll(diff));
+            const TileRecord &record = m_Tiles[index];
+            if (isAlive(m_Target, index)) {
+                Entity tile = scene.createEntityWithUUID(record.Id, record.Tag);
+                tile.getComponent<TransformComponent>() = record.Transform;
+                tile.addComponent<TileComponent>(record.Tile);
+                tile.addComponent<SpriteComponent>(record.Sprite);
+            } else if (Entity tile = scene.getEntityByUuid(record.Id)) {
+                scene.destroyEntity(tile);
+            }
+        }
+    }
+    m_Alive.swap(m_Target);
+    m_AliveCount = snapshot.AliveCount;
+
+    for (u32 i = 0; i < m_DynamicIds.size(); i++) {
+        const auto &state = snapshot.Dynamic[i];
+        if (Entity entity = scene.getEntityByUuid(state.Id)) {
+            entity.getComponent<TransformComponent>() = state.Transform;
+            if (entity.hasComponent<BallComponent>()) {
+                entity.getComponent<BallComponent>() = state.Ball;
+            }
+        }
+    }
+    counters = snapshot.Counters;
+
+    // Later snapshots and keyframes describe a future that no longer happens
+    m_Tick = snapshot.Tick + 1;
+    m_LastKeyframe = snapshot.Keyframe;
+    for (auto &keyframe: m_Keyframes) {
+        if (keyframe.Tick != ~0u && keyframe.Tick > snapshot.Tick) {
+            keyframe.Tick = ~0u;
+        }
+    }
+    return true;
+}
+
+u32 SceneSnapshots::getAvailable() const {
+    // Snapshots older than the first keyframe in the ring can't be rebuilt
+    u32 oldest = m_Tick;
+    for (const auto &keyframe: m_Keyframes) {
+        if (keyframe.Tick != ~0u && keyframe.Tick + 1 >= m_First && keyframe.Tick < oldest) {
+            oldest = keyframe.Tick;
+        }
+    }
+    return m_Tick - std::max(oldest, m_First);
+}
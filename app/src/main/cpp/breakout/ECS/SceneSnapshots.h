@@ -0,0 +1,139 @@
+/*
+MIT License
+
+Copyright (c) 2023 Victor Falcon Zaro
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <Common.h>
+#include "Components.h"
+
+#include <array>
+#include <vector>
+
+class Scene;
+
+//! Game counters saved along with each snapshot
+struct SnapshotCounters
+{
+	u32 Score = 0;
+	u32 Lives = 0;
+};
+
+//! Ring of the dynamic state of a level, captured every tick
+/*
+* Only what changes during play is recorded: the transforms of the player and the
+* balls, the ball speeds, the counters and which tiles are still alive. Tiles only
+* ever disappear, so a snapshot stores the tiles removed since the previous one and
+* every c_KeyframeInterval ticks a keyframe stores the full alive bitset. Restoring
+* replays at most one keyframe interval of removals, however far back it goes.
+* Capturing allocates nothing.
+*/
+class SceneSnapshots
+{
+public:
+	static constexpr u32 c_Capacity = 256; /**< Snapshots kept, a bit over 4 seconds at 60Hz */
+	static constexpr u32 c_KeyframeInterval = 32;
+	static constexpr u32 c_MaxRemovals = 8; /**< Removals a delta holds, more force a keyframe */
+	static constexpr u32 c_MaxDynamicEntities = 4;
+
+	//! Starts recording a level, dropping every snapshot
+	//! Records the tiles of the scene, only these are tracked and restored
+	//! @param scene Freshly loaded level
+	void reset(Scene &scene);
+
+	//! Records the state of the scene
+	//! @param scene Scene given to reset
+	//! @param counters Game counters at this tick
+	void capture(Scene &scene, const SnapshotCounters &counters);
+
+	//! Puts the scene back in the state of an earlier tick and drops the later snapshots
+	//! @param scene Scene given to reset
+	//! @param ticksAgo 0 for the latest snapshot
+	//! @param counters Filled with the counters of the snapshot
+	//! @return False if the snapshot is no longer available
+	bool restore(Scene &scene, u32 ticksAgo, SnapshotCounters &counters);
+
+	//! @return Amount of snapshots that can be restored
+	NODISCARD u32 getAvailable() const;
+
+private:
+	struct DynamicState
+	{
+		UUID Id;
+		TransformComponent Transform;
+		BallComponent Ball;
+	};
+
+	struct TileRecord
+	{
+		UUID Id;
+		StringId Tag;
+		TransformComponent Transform;
+		TileComponent Tile;
+		SpriteComponent Sprite;
+	};
+
+	struct Snapshot
+	{
+		u32 Tick = 0;
+		u32 Keyframe = 0; /**< Tick of the keyframe removals are applied to */
+		u32 AliveCount = 0;
+		SnapshotCounters Counters;
+		std::array<DynamicState, c_MaxDynamicEntities> Dynamic;
+		std::array<u32, c_MaxRemovals> Removed; /**< Tiles removed on this tick */
+		u32 RemovedCount = 0;
+	};
+
+	struct Keyframe
+	{
+		u32 Tick = ~0u;
+		std::vector<u64> Alive;
+	};
+
+	//! Finds the tiles destroyed since the last sync, clearing them in m_Alive
+	//! @return If any tile was removed, listed in m_Removed
+	bool syncAlive(Scene &scene);
+
+	//! Builds the alive bitset of a snapshot into m_Target
+	bool buildTarget(const Snapshot &snapshot);
+
+	static bool isAlive(const std::vector<u64> &bits, u32 index)
+	{
+		return (bits[index / 64] >> (index % 64)) & 1u;
+	}
+
+	static void setAlive(std::vector<u64> &bits, u32 index, bool alive);
+
+	std::vector<TileRecord> m_Tiles{}; /**< Every tile of the level, indexed by the bitsets */
+	std::vector<UUID> m_DynamicIds{};
+	std::vector<Snapshot> m_Snapshots = std::vector<Snapshot>(c_Capacity);
+	std::vector<Keyframe> m_Keyframes = std::vector<Keyframe>(c_Capacity / c_KeyframeInterval + 2);
+	u32 m_NextKeyframe = 0; /**< Keyframe slot written next */
+	u32 m_Tick = 0; /**< Tick of the next capture */
+	u32 m_First = 0; /**< Oldest tick still in the ring */
+	u32 m_LastKeyframe = 0;
+	std::vector<u64> m_Alive{}; /**< Tiles alive in the scene as of the last sync */
+	u32 m_AliveCount = 0;
+	std::vector<u64> m_Target{}; /**< Scratch bitset of restore */
+	std::vector<u32> m_Removed{}; /**< Scratch list of syncAlive */
+};
@@ -0,0 +1,94 @@
+#include "SceneStats.h"
+
+#include <android/log.h>
+#include <android/trace.h>
+
+#include <algorithm>
+#include <cstdio>
+
+void SceneStats::recordQuery(entt::id_type id, std::string_view name, size_t entities) {
+    std::lock_guard lock(m_Mutex);
+    auto &queries = m_Current.Queries;
+    auto query = std::find_if(queries.begin(), queries.end(),
+                              [id](const QueryStats &stats) { return stats.Id == id; });
+    if (query == queries.end()) {
+        query = queries.insert(queries.end(), QueryStats{id, name});
+    }
+    query->Builds++;
+    query->Entities += entities;
+}
+
+void SceneStats::recordCopy(f32 ms) {
+    std::lock_guard lock(m_Mutex);
+    m_Current.Copies++;
+    m_Current.CopyMs += ms;
+}
+
+void SceneStats::onEntityCreated() {
+    std::lock_guard lock(m_Mutex);
+    m_Current.Created++;
+}
+
+void SceneStats::onEntityDestroyed() {
+    std::lock_guard lock(m_Mutex);
+    m_Current.Destroyed++;
+}
+
+void SceneStats::endFrame() {
+    std::lock_guard lock(m_Mutex);
+    // Swapping keeps the query list capacity, queries repeat every frame
+    std::swap(m_Last, m_Current);
+    m_Current.Created = 0;
+    m_Current.Destroyed = 0;
+    m_Current.Copies = 0;
+    m_Current.CopyMs = 0.0f;
+    m_Current.Queries.clear();
+}
+
+void SceneStats::dump(std::string_view label, const std::vector<StorageStats> &storages) const {
+    std::lock_guard lock(m_Mutex);
+    const auto name = static_cast<int>(label.size());
+    __android_log_print(ANDROID_LOG_DEBUG, "AO", "SceneStats: %.*s created %u destroyed %u copies %u (%.3fms)",
+                        name, label.data(), m_Last.Created, m_Last.Destroyed, m_Last.Copies, m_Last.CopyMs);
+
+    __android_log_print(ANDROID_LOG_DEBUG, "AO", "SceneStats: %.*s %-48s %8s %10s",
+                        name, label.data(), "Query", "Builds", "Entities");
+    for (const auto &query: m_Last.Queries) {
+        __android_log_print(ANDROID_LOG_DEBUG, "AO", "SceneStats: %.*s %-48.*s %8u %10llu",
+                            name, label.data(), static_cast<int>(query.Name.size()), query.Name.data(),
+                            query.Builds, static_cast<unsigned long long>(query.Entities));
+    }
+
+    __android_log_print(ANDROID_LOG_DEBUG, "AO", "SceneStats: %.*s %-48s %8s %10s",
+                        name, label.data(), "Storage", "Size", "Capacity");
+    for (const auto &storage: storages) {
+        __android_log_print(ANDROID_LOG_DEBUG, "AO", "SceneStats: %.*s %-48.*s %8zu %10zu",
+                            name, label.data(), static_cast<int>(storage.Name.size()), storage.Name.data(),
+                            storage.Size, storage.Capacity);
+    }
+}
+
+bool SceneStats::isTracing() {
+    return ATrace_isEnabled();
+}
+
+void SceneStats::trace(std::string_view label, const std::vector<StorageStats> &storages) const {
+    std::lock_guard lock(m_Mutex);
+    const auto name = static_cast<int>(label.size());
+    char counter[128];
+    const auto setCounter = [&](std::string_view key, int64_t value) {
+        snprintf(counter, sizeof(counter), "%.*s.%.*s", name, label.data(),
+                 static_cast<int>(key.size()), key.data());
+        ATrace_setCounter(counter, value);
+    };
+
+    setCounter("Created", m_Last.Created);
+    setCounter("Destroyed", m_Last.Destroyed);
+    setCounter("CopyUs", static_cast<int64_t>(m_Last.CopyMs * 1000.0f));
+    for (const auto &query: m_Last.Queries) {
+        setCounter(query.Name, query.Builds);
+    }
+    for (const auto &storage: storages) {
+        setCounter(storage.Name, static_cast<int64_t>(storage.Size));
+    }
+}
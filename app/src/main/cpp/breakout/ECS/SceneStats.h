@@ -0,0 +1,118 @@
+/*
+MIT License
+
+Copyright (c) 2023 Victor Falcon Zaro
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <Common.h>
+#include <Entt/entt.hpp>
+
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+//! Debug counters of a scene
+/*
+* Only recorded when built with BREAKOUT_ECS_STATS, scenes don't create their stats
+* otherwise. Counters accumulate during a frame and are published by endFrame. Queries
+* can be built from systems running in parallel, so recording takes a lock.
+*/
+class SceneStats
+{
+public:
+	//! Builds of a query during a frame
+	struct QueryStats
+	{
+		entt::id_type Id = 0; /**< Identifier of the query */
+		std::string_view Name{}; /**< Components or name of the query */
+		u32 Builds = 0; /**< Times the query was built */
+		u64 Entities = 0; /**< Entities the builds could iterate, a view only knows its smallest pool */
+	};
+
+	//! Size of a component storage
+	struct StorageStats
+	{
+		std::string_view Name{}; /**< Component type */
+		size_t Size = 0; /**< Components in the storage */
+		size_t Capacity = 0; /**< Components the storage holds without growing */
+	};
+
+	//! Counters of a frame
+	struct FrameStats
+	{
+		u32 Created = 0; /**< Entities created */
+		u32 Destroyed = 0; /**< Entities destroyed */
+		u32 Copies = 0; /**< Times the scene was filled by Scene::copy */
+		f32 CopyMs = 0.0f; /**< Time spent in Scene::copy */
+		std::vector<QueryStats> Queries{}; /**< Queries built, in first build order */
+	};
+
+	//! @return If scene counters are being recorded
+	static constexpr bool isEnabled()
+	{
+#ifdef BREAKOUT_ECS_STATS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	//! @return If a system trace is being recorded, so trace() has somewhere to publish
+	static bool isTracing();
+
+	SceneStats() = default;
+
+	DISABLE_MOVE_AND_COPY(SceneStats)
+
+	void recordQuery(entt::id_type id, std::string_view name, size_t entities);
+
+	void recordCopy(f32 ms);
+
+	//! Listener of the id construction signal, every entity has an id
+	void onEntityCreated();
+
+	//! Listener of the id destruction signal
+	void onEntityDestroyed();
+
+	//! Publishes the counters of the current frame and starts a new one
+	void endFrame();
+
+	//! @return Counters of the last finished frame
+	NODISCARD const FrameStats &getLastFrame() const { return m_Last; }
+
+	//! Logs the last frame counters and the given storages as a table
+	//! @param label Name of the scene in the log
+	//! @param storages Storages of the scene
+	void dump(std::string_view label, const std::vector<StorageStats> &storages) const;
+
+	//! Publishes the last frame counters as profiler counters, shown in system traces
+	//! Check isTracing() first, the counters are dropped when no trace is recorded
+	//! @param label Prefix of the counter names
+	//! @param storages Storages of the scene
+	void trace(std::string_view label, const std::vector<StorageStats> &storages) const;
+
+private:
+	mutable std::mutex m_Mutex;
+	FrameStats m_Current{};
+	FrameStats m_Last{};
+};
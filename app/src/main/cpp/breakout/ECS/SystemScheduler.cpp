@@ -0,0 +1,90 @@
+#include "SystemScheduler.h"
+#include "Scene.h"
+#include "Core/AndroidOut.h"
+
+#include <algorithm>
+#include <chrono>
+
+// Weight of the last run in the average time
+static constexpr f32 c_AverageWeight = 0.1f;
+
+static bool intersects(const std::vector<entt::id_type> &a, const std::vector<entt::id_type> &b) {
+    return std::any_of(a.begin(), a.end(), [&b](entt::id_type id) {
+        return std::find(b.begin(), b.end(), id) != b.end();
+    });
+}
+
+bool SystemAccess::conflicts(const SystemAccess &other) const {
+    return m_Exclusive || other.m_Exclusive
+           || intersects(m_Writes, other.m_Writes)
+           || intersects(m_Writes, other.m_Reads)
+           || intersects(m_Reads, other.m_Writes);
+}
+
+void SystemAccess::assureStorages(SceneRegistry &registry) const {
+    for (auto assure: m_Storages) {
+        assure(registry);
+    }
+}
+
+SystemScheduler::SystemScheduler(ThreadPool &pool)
+        : m_Pool(pool) {
+}
+
+void SystemScheduler::addSystem(std::string_view name, const SystemAccess &access, SystemFunction system) {
+    m_Systems.push_back({access, std::move(system)});
+    m_Stats.push_back({StringId(name)});
+    m_Dirty = true;
+}
+
+void SystemScheduler::buildWaves() {
+    m_Waves.clear();
+    for (u32 i = 0; i < m_Systems.size(); i++) {
+        u32 wave = 0;
+        for (u32 j = 0; j < i; j++) {
+            if (m_Systems[i].Access.conflicts(m_Systems[j].Access)) {
+                wave = std::max(wave, m_Stats[j].Wave + 1);
+            }
+        }
+
+        m_Stats[i].Wave = wave;
+        if (wave >= m_Waves.size()) {
+            m_Waves.resize(wave + 1);
+        }
+        m_Waves[wave].push_back(i);
+    }
+    m_Dirty = false;
+}
+
+void SystemScheduler::run(Scene &scene, f32 dt) {
+    if (m_Dirty) {
+        buildWaves();
+    }
+
+    for (const auto &system: m_Systems) {
+        system.Access.assureStorages(scene.m_Registry);
+    }
+
+    for (const auto &wave: m_Waves) {
+        m_Pool.parallelFor(static_cast<u32>(wave.size()), [&](u32 i) {
+            runSystem(wave[i], scene, dt);
+        });
+    }
+}
+
+void SystemScheduler::runSystem(u32 index, Scene &scene, f32 dt) {
+    const auto start = std::chrono::steady_clock::now();
+    m_Systems[index].Function(scene, dt);
+    const f32 ms = std::chrono::duration<f32, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    auto &stats = m_Stats[index];
+    stats.LastMs = ms;
+    stats.AverageMs += (ms - stats.AverageMs) * c_AverageWeight;
+}
+
+void SystemScheduler::dumpStats() const {
+    for (const auto &stats: m_Stats) {
+        aout << "System " << stats.Name.str() << " wave " << stats.Wave << ": " << stats.LastMs
+             << "ms, average " << stats.AverageMs << "ms" << std::endl;
+    }
+}
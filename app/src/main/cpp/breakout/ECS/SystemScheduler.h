@@ -0,0 +1,148 @@
+/*
+MIT License
+
+Copyright (c) 2023 Victor Falcon Zaro
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <Common.h>
+#include <Core/StringId.h>
+#include <Core/ThreadPool.h>
+#include <Entt/entt.hpp>
+#include "Scene.h"
+
+#include <functional>
+#include <vector>
+
+//! Components a system reads and writes
+/*
+* Two systems conflict when one writes a component the other reads or writes. Systems
+* that change the entity set, or share state outside the scene, are marked exclusive and
+* run alone. A system may grow the storages it writes, the scene pool they allocate from
+* is locked.
+*/
+class SystemAccess
+{
+public:
+	template<typename... Component>
+	SystemAccess &reads()
+	{
+		(m_Reads.push_back(entt::type_hash<Component>::value()), ...);
+		(m_Storages.push_back(&assure<Component>), ...);
+		return *this;
+	}
+
+	template<typename... Component>
+	SystemAccess &writes()
+	{
+		(m_Writes.push_back(entt::type_hash<Component>::value()), ...);
+		(m_Storages.push_back(&assure<Component>), ...);
+		return *this;
+	}
+
+	SystemAccess &exclusive()
+	{
+		m_Exclusive = true;
+		return *this;
+	}
+
+	//! @return If both systems can't run at the same time
+	NODISCARD bool conflicts(const SystemAccess &other) const;
+
+	//! Creates the storage of every declared component, views of systems running in
+	//! parallel must never add a storage to the registry
+	void assureStorages(SceneRegistry &registry) const;
+
+private:
+	template<typename Component>
+	static void assure(SceneRegistry &registry)
+	{
+		registry.storage<Component>();
+	}
+
+	std::vector<entt::id_type> m_Reads{};
+	std::vector<entt::id_type> m_Writes{};
+	std::vector<void (*)(SceneRegistry &)> m_Storages{};
+	bool m_Exclusive = false;
+};
+
+//! Runs the registered systems over a scene
+/*
+* Systems are ordered as registered. Each one depends on every earlier system it
+* conflicts with, and systems are grouped in waves that start once their dependencies
+* are done. The systems of a wave run in parallel on the thread pool.
+*/
+class SystemScheduler
+{
+public:
+	using SystemFunction = std::function<void(Scene &scene, f32 dt)>;
+
+	//! Timing of a system
+	struct SystemStats
+	{
+		StringId Name; /**< Name given on registration */
+		u32 Wave = 0; /**< Wave the system runs in */
+		f32 LastMs = 0.0f; /**< Time of the last run */
+		f32 AverageMs = 0.0f; /**< Smoothed time over the last runs */
+	};
+
+	//! Constructor
+	//! @param pool Threads systems of the same wave run on
+	explicit SystemScheduler(ThreadPool &pool);
+
+	DISABLE_MOVE_AND_COPY(SystemScheduler)
+
+	//! Registers a system, run after the earlier systems it conflicts with
+	//! @param name Name shown in the stats
+	//! @param access Components the system reads and writes
+	//! @param system Function run every frame
+	void addSystem(std::string_view name, const SystemAccess &access, SystemFunction system);
+
+	//! Runs every system once
+	//! @param scene Scene the systems run on
+	//! @param dt Frame time in milliseconds
+	void run(Scene &scene, f32 dt);
+
+	//! @return Timings of the systems, in registration order
+	NODISCARD const std::vector<SystemStats> &getStats() const { return m_Stats; }
+
+	//! Logs the timings of every system
+	void dumpStats() const;
+
+private:
+	struct System
+	{
+		SystemAccess Access;
+		SystemFunction Function;
+	};
+
+	//! Assigns each system the wave after its latest dependency
+	void buildWaves();
+
+	void runSystem(u32 index, Scene &scene, f32 dt);
+
+	ThreadPool &m_Pool;
+	std::vector<System> m_Systems{};
+	std::vector<SystemStats> m_Stats{};
+	std::vector<std::vector<u32>> m_Waves{}; /**< System indices of each wave */
+	bool m_Dirty = false; /**< Waves need to be rebuilt */
+};
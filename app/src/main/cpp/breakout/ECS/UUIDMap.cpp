@@ -0,0 +1,112 @@
+#include "UUIDMap.h"
+
+#include <algorithm>
+
+static constexpr size_t c_MinCapacity = 16;
+
+size_t UUIDMap::slotOf(u64 key) const {
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> m_Shift);
+}
+
+void UUIDMap::insert(UUID uuid, entt::entity entity) {
+    // Kept at most half full so probe sequences stay short
+    if ((m_Size + 1) * 2 > m_Slots.size()) {
+        rehash(std::max(c_MinCapacity, m_Slots.size() * 2));
+    }
+
+    const size_t mask = m_Slots.size() - 1;
+    for (size_t slot = slotOf(uuid);; slot = (slot + 1) & mask) {
+        auto &entry = m_Slots[slot];
+        if (entry.Entity == entt::null) {
+            entry = {uuid, entity};
+            m_Size++;
+            return;
+        }
+        if (entry.Key == uuid) {
+            entry.Entity = entity;
+            return;
+        }
+    }
+}
+
+entt::entity UUIDMap::find(UUID uuid) const {
+    if (m_Slots.empty()) {
+        return entt::null;
+    }
+
+    const size_t mask = m_Slots.size() - 1;
+    for (size_t slot = slotOf(uuid);; slot = (slot + 1) & mask) {
+        const auto &entry = m_Slots[slot];
+        if (entry.Entity == entt::null || entry.Key == uuid) {
+            return entry.Entity;
+        }
+    }
+}
+
+bool UUIDMap::erase(UUID uuid) {
+    if (m_Slots.empty()) {
+        return false;
+    }
+
+    const size_t mask = m_Slots.size() - 1;
+    size_t hole = slotOf(uuid);
+    while (m_Slots[hole].Key != uuid) {
+        if (m_Slots[hole].Entity == entt::null) {
+            return false;
+        }
+        hole = (hole + 1) & mask;
+    }
+    if (m_Slots[hole].Entity == entt::null) {
+        return false;
+    }
+
+    // Move back every following entry whose home slot is at or before the hole
+    for (size_t slot = (hole + 1) & mask; m_Slots[slot].Entity != entt::null; slot = (slot + 1) & mask) {
+        const size_t home = slotOf(m_Slots[slot].Key);
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+            m_Slots[hole] = m_Slots[slot];
+            hole = slot;
+        }
+    }
+    m_Slots[hole] = {};
+    m_Size--;
+    return true;
+}
+
+void UUIDMap::reserve(size_t count) {
+    size_t capacity = c_MinCapacity;
+    while (capacity < count * 2) {
+        capacity *= 2;
+    }
+    if (capacity > m_Slots.size()) {
+        rehash(capacity);
+    }
+}
+
+void UUIDMap::clear() {
+    m_Slots.clear();
+    m_Size = 0;
+    m_Shift = 64;
+}
+
+void UUIDMap::rehash(size_t capacity) {
+    std::vector<Slot> slots(capacity);
+    slots.swap(m_Slots);
+
+    m_Shift = 64;
+    for (size_t size = capacity; size > 1; size >>= 1) {
+        m_Shift--;
+    }
+
+    const size_t mask = capacity - 1;
+    for (const auto &entry: slots) {
+        if (entry.Entity == entt::null) {
+            continue;
+        }
+        size_t slot = slotOf(entry.Key);
+        while (m_Slots[slot].Entity != entt::null) {
+            slot = (slot + 1) & mask;
+        }
+        m_Slots[slot] = entry;
+    }
+}
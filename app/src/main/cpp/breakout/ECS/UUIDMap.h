@@ -0,0 +1,80 @@
+/*
+MIT License
+
+Copyright (c) 2023 Victor Falcon Zaro
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <Core/UUID.h>
+#include <Common.h>
+#include <Entt/entt.hpp>
+
+#include <vector>
+
+//! UUID to entity map
+/*
+* Open addressing table with linear probing, stored as one flat array of key/entity
+* pairs so a lookup touches a single cache line in the common case. Keys are spread
+* with a Fibonacci hash, UUIDs loaded from disk or made by hand need not be random.
+* Removal shifts the following entries back instead of leaving tombstones.
+*/
+class UUIDMap
+{
+public:
+	//! Inserts or replaces the entity of a UUID
+	//! @param uuid Key
+	//! @param entity Entity of the UUID, must not be entt::null
+	void insert(UUID uuid, entt::entity entity);
+
+	//! Finds the entity of a UUID
+	//! @param uuid Key
+	//! @return The entity, entt::null if the UUID is not in the map
+	NODISCARD entt::entity find(UUID uuid) const;
+
+	//! Removes a UUID
+	//! @param uuid Key
+	//! @return True if the UUID was in the map
+	bool erase(UUID uuid);
+
+	//! Grows the table to hold count entries without rehashing
+	//! @param count Amount of entries
+	void reserve(size_t count);
+
+	void clear();
+
+	NODISCARD size_t size() const { return m_Size; }
+
+private:
+	struct Slot
+	{
+		u64 Key = 0;
+		entt::entity Entity = entt::null;
+	};
+
+	NODISCARD size_t slotOf(u64 key) const;
+
+	void rehash(size_t capacity);
+
+	std::vector<Slot> m_Slots{};
+	size_t m_Size = 0;
+	u32 m_Shift = 64;
+};
@@ -0,0 +1,27 @@
+#include "Core/AndroidOut.h"
+#include "FrameArena.h"
+
+namespace FrameArena
+{
+	namespace
+	{
+		constexpr size_t c_Capacity = 512 * 1024;
+	}
+
+	LinearArena &get()
+	{
+		static LinearArena s_Arena(c_Capacity);
+		return s_Arena;
+	}
+
+	void reset()
+	{
+		LinearArena &arena = get();
+		if (arena.getOverflowCount() > 0)
+		{
+			aout << "FrameArena: " << arena.getOverflowCount()
+			     << " allocations fell back to the heap" << std::endl;
+		}
+		arena.reset();
+	}
+}
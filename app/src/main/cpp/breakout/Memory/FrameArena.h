@@ -0,0 +1,70 @@
+/*
+MIT License
+
+Copyright (c) 2023 Victor Falcon Zaro
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef _FRAME_ARENA_H_
+#define _FRAME_ARENA_H_
+
+#include <type_traits>
+#include <vector>
+#include "LinearArena.h"
+
+//! Scratch memory that lives for a single frame
+/*
+*	Transient data (vertices, parse buffers...) is drawn from here instead of the
+*	heap. Everything allocated is reclaimed at the end of the frame.
+*/
+namespace FrameArena
+{
+	//! Vector whose storage is valid until the end of the frame
+	template<typename T>
+	using Vector = std::vector<T, ArenaAllocator<T>>;
+
+	//! @return The arena of the current frame
+	NODISCARD LinearArena &get();
+
+	//! Creates an empty vector backed by the frame arena
+	//! @param capacity Elements to reserve up front
+	template<typename T>
+	NODISCARD Vector<T> makeVector(size_t capacity = 0)
+	{
+		Vector<T> vector{ArenaAllocator<T>(get())};
+		vector.reserve(capacity);
+		return vector;
+	}
+
+	//! Allocates an uninitialized array that stays valid until the end of the frame
+	//! Unlike Vector, it is never released early, so it can be referenced by deferred work
+	//! @param count Elements of the array
+	template<typename T>
+	NODISCARD T *allocate(size_t count)
+	{
+		static_assert(std::is_trivially_destructible_v<T>, "Frame arrays are never destroyed");
+		return static_cast<T *>(get().allocate(count * sizeof(T), alignof(T)));
+	}
+
+	//! Reclaims every allocation done during the frame
+	void reset();
+}
+
+#endif
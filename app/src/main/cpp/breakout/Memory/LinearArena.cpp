@@ -0,0 +1,110 @@
+#include "LinearArena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <new>
+
+namespace
+{
+	// Heap fallbacks honour the requested alignment, never below what plain new guarantees
+	std::align_val_t getHeapAlignment(size_t alignment)
+	{
+		return std::align_val_t(std::max<size_t>(alignment, __STDCPP_DEFAULT_NEW_ALIGNMENT__));
+	}
+
+	// Space in front of a heap fallback, keeps the returned pointer aligned
+	size_t getHeaderSize(size_t headerSize, std::align_val_t alignment)
+	{
+		const size_t align = static_cast<size_t>(alignment);
+		return (headerSize + align - 1) & ~(align - 1);
+	}
+}
+
+LinearArena::LinearArena(size_t capacity)
+		: m_Buffer(static_cast<ubyte *>(::operator new(capacity))), m_Capacity(capacity)
+{
+}
+
+LinearArena::~LinearArena()
+{
+	reset();
+	::operator delete(m_Buffer);
+}
+
+void *LinearArena::allocate(size_t size, size_t alignment)
+{
+	const uintptr_t base = reinterpret_cast<uintptr_t>(m_Buffer);
+	const uintptr_t aligned = (base + m_Offset + alignment - 1) & ~(uintptr_t(alignment) - 1);
+	const size_t offset = aligned - base;
+
+	if (offset + size > m_Capacity)
+	{
+		m_Overflows++;
+		const std::align_val_t heapAlignment = getHeapAlignment(alignment);
+		const size_t headerSize = getHeaderSize(sizeof(OverflowBlock), heapAlignment);
+		auto *raw = static_cast<ubyte *>(::operator new(headerSize + size, heapAlignment));
+
+		auto *block = reinterpret_cast<OverflowBlock *>(raw + headerSize - sizeof(OverflowBlock));
+		block->Prev = nullptr;
+		block->Next = m_OverflowBlocks;
+		block->Alignment = static_cast<size_t>(heapAlignment);
+		if (m_OverflowBlocks)
+		{
+			m_OverflowBlocks->Prev = block;
+		}
+		m_OverflowBlocks = block;
+		return raw + headerSize;
+	}
+
+	m_Offset = offset + size;
+	m_Peak = m_Offset > m_Peak ? m_Offset : m_Peak;
+	return m_Buffer + offset;
+}
+
+void LinearArena::deallocate(void *ptr, size_t size, size_t alignment)
+{
+	if (!owns(ptr))
+	{
+		auto *block = reinterpret_cast<OverflowBlock *>(static_cast<ubyte *>(ptr) - sizeof(OverflowBlock));
+		assert(block->Alignment == static_cast<size_t>(getHeapAlignment(alignment)));
+		freeOverflow(block);
+		return;
+	}
+
+	// Roll back the last allocation so growing containers can reuse the space
+	if (static_cast<ubyte *>(ptr) + size == m_Buffer + m_Offset)
+	{
+		m_Offset -= size;
+	}
+}
+
+void LinearArena::reset()
+{
+	while (m_OverflowBlocks)
+	{
+		freeOverflow(m_OverflowBlocks);
+	}
+	m_Offset = 0;
+	m_Overflows = 0;
+}
+
+void LinearArena::freeOverflow(OverflowBlock *block)
+{
+	if (block->Prev)
+	{
+		block->Prev->Next = block->Next;
+	}
+	else
+	{
+		m_OverflowBlocks = block->Next;
+	}
+	if (block->Next)
+	{
+		block->Next->Prev = block->Prev;
+	}
+
+	const std::align_val_t alignment{block->Alignment};
+	const size_t headerSize = getHeaderSize(sizeof(OverflowBlock), alignment);
+	::operator delete(reinterpret_cast<ubyte *>(block + 1) - headerSize, alignment);
+}
@@ -0,0 +1,144 @@
+/*
+MIT License
+
+Copyright (c) 2023 Victor Falcon Zaro
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef _LINEAR_ARENA_H_
+#define _LINEAR_ARENA_H_
+
+#include <Common.h>
+#include <cstddef>
+
+//! Linear (bump) allocator
+/*
+*	Hands out memory from a single preallocated block by bumping an offset.
+*	Individual frees are no-ops except for the most recent allocation, the whole
+*	block is reclaimed at once with reset(). When the block is exhausted the
+*	arena falls back to the heap so callers never fail, the overflows are counted
+*	so the capacity can be tuned. Heap blocks are linked in a list and freed by
+*	reset() like the rest.
+*/
+class LinearArena
+{
+public:
+	//! Constructor
+	//! @param capacity Size in bytes of the backing block
+	explicit LinearArena(size_t capacity);
+
+	//! Destructor
+	~LinearArena();
+
+	DISABLE_MOVE_AND_COPY(LinearArena)
+
+	//! Allocates a block of memory
+	//! @param size Size in bytes
+	//! @param alignment Alignment of the returned pointer
+	//! @return Pointer to the allocated memory
+	NODISCARD void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	//! Releases a block of memory
+	//! Only the most recent allocation is actually reclaimed
+	//! @param ptr Pointer returned by allocate
+	//! @param size Size in bytes given to allocate
+	//! @param alignment Alignment given to allocate
+	void deallocate(void *ptr, size_t size, size_t alignment = alignof(std::max_align_t));
+
+	//! Reclaims every allocation done since the last reset, heap fallbacks included
+	void reset();
+
+	//! @return If the pointer lives inside the backing block
+	NODISCARD bool owns(const void *ptr) const
+	{
+		return ptr >= m_Buffer && ptr < m_Buffer + m_Capacity;
+	}
+
+	NODISCARD size_t getUsed() const { return m_Offset; }
+
+	NODISCARD size_t getCapacity() const { return m_Capacity; }
+
+	//! @return Highest usage reached since creation
+	NODISCARD size_t getPeak() const { return m_Peak; }
+
+	//! @return Allocations that fell back to the heap since the last reset
+	NODISCARD u32 getOverflowCount() const { return m_Overflows; }
+
+private:
+	//! Header in front of every heap fallback
+	struct OverflowBlock
+	{
+		OverflowBlock *Prev;
+		OverflowBlock *Next;
+		size_t Alignment;
+	};
+
+	//! Unlinks and frees a heap fallback
+	void freeOverflow(OverflowBlock *block);
+
+	ubyte *m_Buffer = nullptr; /**< Backing block */
+	size_t m_Capacity = 0; /**< Size of the backing block */
+	size_t m_Offset = 0; /**< Current bump offset */
+	size_t m_Peak = 0; /**< Highest offset reached */
+	u32 m_Overflows = 0; /**< Heap fallbacks since last reset */
+	OverflowBlock *m_OverflowBlocks = nullptr; /**< Heap fallbacks not released yet */
+};
+
+//! STL compatible allocator that draws from a LinearArena
+template<typename T>
+class ArenaAllocator
+{
+public:
+	using value_type = T;
+
+	ArenaAllocator(LinearArena &arena) noexcept
+			: m_Arena(&arena)
+	{
+	}
+
+	template<typename U>
+	ArenaAllocator(const ArenaAllocator<U> &other) noexcept
+			: m_Arena(other.getArena())
+	{
+	}
+
+	NODISCARD T *allocate(size_t count)
+	{
+		return static_cast<T *>(m_Arena->allocate(count * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T *ptr, size_t count) noexcept
+	{
+		m_Arena->deallocate(ptr, count * sizeof(T), alignof(T));
+	}
+
+	NODISCARD LinearArena *getArena() const { return m_Arena; }
+
+	template<typename U>
+	bool operator==(const ArenaAllocator<U> &other) const { return m_Arena == other.getArena(); }
+
+	template<typename U>
+	bool operator!=(const ArenaAllocator<U> &other) const { return m_Arena != other.getArena(); }
+
+private:
+	LinearArena *m_Arena; /**< Arena the memory is drawn from */
+};
+
+#endif
@@ -0,0 +1,97 @@
+#include "MemoryPool.h"
+
+#include <new>
+
+MemoryPool::~MemoryPool()
+{
+	while (m_Chunks)
+	{
+		Chunk *next = m_Chunks->Next;
+		::operator delete(m_Chunks);
+		m_Chunks = next;
+	}
+}
+
+size_t MemoryPool::classOf(size_t size, size_t &classSize)
+{
+	// 16, 32, 48 and 64 bytes, then four classes per power of two
+	if (size <= 64)
+	{
+		classSize = size <= 16 ? 16 : (size + 15) & ~size_t(15);
+		return classSize / 16 - 1;
+	}
+
+	size_t power = 6;
+	while ((size_t(1) << (power + 1)) < size)
+	{
+		power++;
+	}
+	const size_t base = size_t(1) << power;
+	const size_t step = base / 4;
+	const size_t sub = (size - 1 - base) / step;
+	classSize = base + (sub + 1) * step;
+	return 4 + (power - 6) * 4 + sub;
+}
+
+void *MemoryPool::allocate(size_t size, size_t alignment)
+{
+	std::lock_guard lock(m_Mutex);
+	if (isLarge(size, alignment))
+	{
+		m_HeapAllocations++;
+		m_Reserved += size;
+		m_Used += size;
+		return ::operator new(size, std::align_val_t(alignment));
+	}
+
+	size_t classSize = 0;
+	const size_t index = classOf(size, classSize);
+	m_Used += classSize;
+
+	if (FreeBlock *block = m_FreeLists[index])
+	{
+		m_FreeLists[index] = block->Next;
+		return block;
+	}
+
+	if (m_Cursor + classSize > m_End)
+	{
+		// The tail of the previous chunk is left unused, it is smaller than the block
+		auto *chunk = static_cast<Chunk *>(::operator new(c_ChunkSize));
+		chunk->Next = m_Chunks;
+		m_Chunks = chunk;
+		m_Cursor = reinterpret_cast<std::byte *>(chunk) + c_Alignment;
+		m_End = reinterpret_cast<std::byte *>(chunk) + c_ChunkSize;
+		m_HeapAllocations++;
+		m_Reserved += c_ChunkSize;
+	}
+
+	void *block = m_Cursor;
+	m_Cursor += classSize;
+	return block;
+}
+
+void MemoryPool::deallocate(void *ptr, size_t size, size_t alignment)
+{
+	if (!ptr)
+	{
+		return;
+	}
+
+	std::lock_guard lock(m_Mutex);
+	if (isLarge(size, alignment))
+	{
+		m_Reserved -= size;
+		m_Used -= size;
+		::operator delete(ptr, std::align_val_t(alignment));
+		return;
+	}
+
+	size_t classSize = 0;
+	const size_t index = classOf(size, classSize);
+	m_Used -= classSize;
+
+	auto *block = static_cast<FreeBlock *>(ptr);
+	block->Next = m_FreeLists[index];
+	m_FreeLists[index] = block;
+}
@@ -0,0 +1,184 @@
+/*
+MIT License
+
+Copyright (c) 2023 Victor Falcon Zaro
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef _MEMORY_POOL_H_
+#define _MEMORY_POOL_H_
+
+#include <Common.h>
+#include <array>
+#include <cstddef>
+#include <mutex>
+
+//! Size class pool allocator
+/*
+*	Small blocks are carved out of large chunks and recycled through one free list
+*	per size class, so containers growing and shrinking never reach the system heap.
+*	Classes are spaced a quarter of a power of two apart, bounding the rounding waste.
+*	Blocks over the largest class go straight to the heap. Every chunk is released
+*	at once when the pool is destroyed. Allocating and freeing take a lock, systems running
+*	in parallel can grow the storages of the scene that owns the pool.
+*/
+class MemoryPool
+{
+public:
+	//! Size of the chunks small blocks are carved from
+	static constexpr size_t c_ChunkSize = 128 * 1024;
+	//! Largest block served from the chunks
+	static constexpr size_t c_MaxBlockSize = 64 * 1024;
+	static_assert(c_MaxBlockSize <= c_ChunkSize / 2, "A chunk must fit its header and the largest block");
+
+	MemoryPool() = default;
+
+	//! Destructor
+	//! Releases every chunk, blocks still allocated from them become invalid
+	~MemoryPool();
+
+	DISABLE_MOVE_AND_COPY(MemoryPool)
+
+	//! Allocates a block of memory
+	//! @param size Size in bytes
+	//! @param alignment Alignment of the returned pointer
+	//! @return Pointer to the allocated memory
+	NODISCARD void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	//! Returns a block to its size class
+	//! @param ptr Pointer returned by allocate
+	//! @param size Size in bytes given to allocate
+	//! @param alignment Alignment given to allocate
+	void deallocate(void *ptr, size_t size, size_t alignment = alignof(std::max_align_t));
+
+	//! @return Bytes currently handed out, after rounding to the size classes
+	NODISCARD size_t getUsed() const
+	{
+		std::lock_guard lock(m_Mutex);
+		return m_Used;
+	}
+
+	//! @return Bytes taken from the heap, chunks and large blocks
+	NODISCARD size_t getReserved() const
+	{
+		std::lock_guard lock(m_Mutex);
+		return m_Reserved;
+	}
+
+	//! @return Heap allocations done by the pool since its creation
+	NODISCARD u32 getHeapAllocationCount() const
+	{
+		std::lock_guard lock(m_Mutex);
+		return m_HeapAllocations;
+	}
+
+private:
+	static constexpr size_t c_ClassCount = 44;
+
+	struct FreeBlock
+	{
+		FreeBlock *Next;
+	};
+
+	struct Chunk
+	{
+		Chunk *Next;
+	};
+
+	//! Maps a size to its class
+	//! @param size Requested size
+	//! @param classSize Size of the blocks of the class
+	//! @return Index of the class
+	static size_t classOf(size_t size, size_t &classSize);
+
+	//! @return If the block can't come from the chunks
+	static bool isLarge(size_t size, size_t alignment)
+	{
+		return size > c_MaxBlockSize || alignment > c_Alignment;
+	}
+
+	//! Chunk blocks are aligned to this
+	static constexpr size_t c_Alignment = 16;
+
+	mutable std::mutex m_Mutex; /**< Guards the free lists, the chunks and the counters */
+	std::array<FreeBlock *, c_ClassCount> m_FreeLists{}; /**< Recycled blocks of each class */
+	Chunk *m_Chunks = nullptr; /**< Every chunk, newest first */
+	std::byte *m_Cursor = nullptr; /**< Next free byte of the newest chunk */
+	std::byte *m_End = nullptr; /**< End of the newest chunk */
+	size_t m_Used = 0;
+	size_t m_Reserved = 0;
+	u32 m_HeapAllocations = 0;
+};
+
+//! STL compatible allocator that draws from a MemoryPool
+//! Default constructed allocators use the heap
+template<typename T>
+class PoolAllocator
+{
+public:
+	using value_type = T;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	PoolAllocator() noexcept = default;
+
+	PoolAllocator(MemoryPool &pool) noexcept
+			: m_Pool(&pool)
+	{
+	}
+
+	template<typename U>
+	PoolAllocator(const PoolAllocator<U> &other) noexcept
+			: m_Pool(other.getPool())
+	{
+	}
+
+	NODISCARD T *allocate(size_t count)
+	{
+		if (!m_Pool)
+		{
+			return static_cast<T *>(::operator new(count * sizeof(T)));
+		}
+		return static_cast<T *>(m_Pool->allocate(count * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T *ptr, size_t count) noexcept
+	{
+		if (!m_Pool)
+		{
+			::operator delete(ptr);
+			return;
+		}
+		m_Pool->deallocate(ptr, count * sizeof(T), alignof(T));
+	}
+
+	NODISCARD MemoryPool *getPool() const { return m_Pool; }
+
+	template<typename U>
+	bool operator==(const PoolAllocator<U> &other) const { return m_Pool == other.getPool(); }
+
+	template<typename U>
+	bool operator!=(const PoolAllocator<U> &other) const { return m_Pool != other.getPool(); }
+
+private:
+	MemoryPool *m_Pool = nullptr; /**< Pool the memory is drawn from, the heap if null */
+};
+
+#endif
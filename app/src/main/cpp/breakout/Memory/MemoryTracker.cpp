@@ -0,0 +1,275 @@
+#include "MemoryTracker.h"
+
+#include <android/log.h>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace MemoryTracker
+{
+	namespace
+	{
+		constexpr size_t c_TagCount = static_cast<size_t>(MemoryTag::Count);
+		constexpr const char *c_TagNames[c_TagCount] = {
+				"General", "Scene", "Renderer", "Fonts", "Textures"
+		};
+
+		struct TagCounters
+		{
+			std::atomic<u64> LiveBytes{0};
+			std::atomic<u64> PeakBytes{0};
+			std::atomic<u64> GpuBytes{0};
+			std::atomic<u64> PeakGpuBytes{0};
+			std::atomic<u32> LiveAllocations{0};
+			std::atomic<u32> Allocations{0};
+			std::atomic<u32> FrameAllocations{0};
+			std::atomic<u64> Budget{0};
+			std::atomic<u64> GpuBudget{0};
+		};
+
+		// Plain arrays of atomics, usable before any static constructor has run
+		std::array<TagCounters, c_TagCount> g_Counters;
+		std::atomic<u32> g_Allocations{0};
+		std::atomic<u32> g_FrameAllocations{0};
+
+		thread_local MemoryTag t_CurrentTag = MemoryTag::General;
+
+		void updatePeak(std::atomic<u64> &peak, u64 value)
+		{
+			u64 current = peak.load(std::memory_order_relaxed);
+			while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed))
+			{
+			}
+		}
+
+		// Logs through the android logger directly, this runs inside operator new
+		void checkBudget(MemoryTag tag, u64 value, u64 budget, const char *kind)
+		{
+			if (budget == 0 || value <= budget)
+			{
+				return;
+			}
+
+			__android_log_print(ANDROID_LOG_DEBUG, "AO", "MemoryTracker: %s %s budget exceeded (%llu / %llu bytes)",
+			                    c_TagNames[static_cast<size_t>(tag)], kind,
+			                    static_cast<unsigned long long>(value), static_cast<unsigned long long>(budget));
+			assert(!"Memory budget exceeded");
+		}
+	}
+
+	MemoryTag getCurrentTag()
+	{
+		return t_CurrentTag;
+	}
+
+	void setCurrentTag(MemoryTag tag)
+	{
+		t_CurrentTag = tag;
+	}
+
+	void recordAllocation(MemoryTag tag, size_t size)
+	{
+		TagCounters &counters = g_Counters[static_cast<size_t>(tag)];
+		const u64 live = counters.LiveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+		updatePeak(counters.PeakBytes, live);
+		counters.LiveAllocations.fetch_add(1, std::memory_order_relaxed);
+		counters.Allocations.fetch_add(1, std::memory_order_relaxed);
+		g_Allocations.fetch_add(1, std::memory_order_relaxed);
+
+		checkBudget(tag, live, counters.Budget.load(std::memory_order_relaxed), "heap");
+	}
+
+	void recordFree(MemoryTag tag, size_t size)
+	{
+		TagCounters &counters = g_Counters[static_cast<size_t>(tag)];
+		counters.LiveBytes.fetch_sub(size, std::memory_order_relaxed);
+		counters.LiveAllocations.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	void recordGpuAllocation(MemoryTag tag, size_t size)
+	{
+		TagCounters &counters = g_Counters[static_cast<size_t>(tag)];
+		const u64 live = counters.GpuBytes.fetch_add(size, std::memory_order_relaxed) + size;
+		updatePeak(counters.PeakGpuBytes, live);
+
+		checkBudget(tag, live, counters.GpuBudget.load(std::memory_order_relaxed), "GPU");
+	}
+
+	void recordGpuFree(MemoryTag tag, size_t size)
+	{
+		g_Counters[static_cast<size_t>(tag)].GpuBytes.fetch_sub(size, std::memory_order_relaxed);
+	}
+
+	void setBudget(MemoryTag tag, u64 bytes)
+	{
+		g_Counters[static_cast<size_t>(tag)].Budget = bytes;
+	}
+
+	void setGpuBudget(MemoryTag tag, u64 bytes)
+	{
+		g_Counters[static_cast<size_t>(tag)].GpuBudget = bytes;
+	}
+
+	TagStats getStats(MemoryTag tag)
+	{
+		const TagCounters &counters = g_Counters[static_cast<size_t>(tag)];
+
+		TagStats stats;
+		stats.LiveBytes = counters.LiveBytes;
+		stats.PeakBytes = counters.PeakBytes;
+		stats.GpuBytes = counters.GpuBytes;
+		stats.PeakGpuBytes = counters.PeakGpuBytes;
+		stats.LiveAllocations = counters.LiveAllocations;
+		stats.FrameAllocations = counters.FrameAllocations;
+		return stats;
+	}
+
+	u32 getFrameAllocations()
+	{
+		return g_FrameAllocations;
+	}
+
+	void endFrame()
+	{
+		g_FrameAllocations = g_Allocations.exchange(0, std::memory_order_relaxed);
+		for (TagCounters &counters: g_Counters)
+		{
+			counters.FrameAllocations = counters.Allocations.exchange(0, std::memory_order_relaxed);
+		}
+	}
+
+	void dump()
+	{
+		__android_log_print(ANDROID_LOG_DEBUG, "AO", "MemoryTracker: %-10s %12s %12s %12s %12s %8s %8s",
+		                    "Tag", "Live", "Peak", "GPU", "GPU peak", "Blocks", "Frame");
+		for (size_t i = 0; i < c_TagCount; i++)
+		{
+			const TagStats stats = getStats(static_cast<MemoryTag>(i));
+			__android_log_print(ANDROID_LOG_DEBUG, "AO", "MemoryTracker: %-10s %12llu %12llu %12llu %12llu %8u %8u",
+			                    c_TagNames[i],
+			                    static_cast<unsigned long long>(stats.LiveBytes),
+			                    static_cast<unsigned long long>(stats.PeakBytes),
+			                    static_cast<unsigned long long>(stats.GpuBytes),
+			                    static_cast<unsigned long long>(stats.PeakGpuBytes),
+			                    stats.LiveAllocations, stats.FrameAllocations);
+		}
+	}
+}
+
+#ifdef BREAKOUT_MEMORY_TRACKING
+
+namespace
+{
+	// Prepended to every heap block so frees can be accounted to the allocating tag
+	struct AllocationHeader
+	{
+		u64 Size;
+		u32 Offset;
+		MemoryTag Tag;
+	};
+
+	constexpr size_t c_HeaderSize = 16;
+	static_assert(sizeof(AllocationHeader) <= c_HeaderSize, "Allocation header doesn't fit");
+
+	void *trackedAllocate(size_t size, size_t alignment) noexcept
+	{
+		alignment = alignment < c_HeaderSize ? c_HeaderSize : alignment;
+
+		// malloc returns 16 byte aligned blocks, so the padding never exceeds the alignment
+		auto *raw = static_cast<ubyte *>(malloc(size + alignment));
+		if (!raw)
+		{
+			return nullptr;
+		}
+
+		const uintptr_t user = (reinterpret_cast<uintptr_t>(raw) + c_HeaderSize + alignment - 1) &
+		                       ~(uintptr_t(alignment) - 1);
+
+		auto *header = reinterpret_cast<AllocationHeader *>(user - c_HeaderSize);
+		header->Size = size;
+		header->Offset = static_cast<u32>(user - reinterpret_cast<uintptr_t>(raw));
+		header->Tag = MemoryTracker::getCurrentTag();
+
+		MemoryTracker::recordAllocation(header->Tag, size);
+		return reinterpret_cast<void *>(user);
+	}
+
+	void trackedFree(void *ptr) noexcept
+	{
+		if (!ptr)
+		{
+			return;
+		}
+
+		auto *header = reinterpret_cast<AllocationHeader *>(static_cast<ubyte *>(ptr) - c_HeaderSize);
+		MemoryTracker::recordFree(header->Tag, header->Size);
+		free(static_cast<ubyte *>(ptr) - header->Offset);
+	}
+
+	void *trackedAllocateOrThrow(size_t size, size_t alignment)
+	{
+		void *ptr = trackedAllocate(size, alignment);
+		if (!ptr)
+		{
+			throw std::bad_alloc();
+		}
+		return ptr;
+	}
+}
+
+void *operator new(size_t size) { return trackedAllocateOrThrow(size, c_HeaderSize); }
+
+void *operator new[](size_t size) { return trackedAllocateOrThrow(size, c_HeaderSize); }
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return trackedAllocate(size, c_HeaderSize); }
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return trackedAllocate(size, c_HeaderSize); }
+
+void *operator new(size_t size, std::align_val_t alignment)
+{
+	return trackedAllocateOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void *operator new[](size_t size, std::align_val_t alignment)
+{
+	return trackedAllocateOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+	return trackedAllocate(size, static_cast<size_t>(alignment));
+}
+
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+	return trackedAllocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *ptr) noexcept { trackedFree(ptr); }
+
+void operator delete[](void *ptr) noexcept { trackedFree(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { trackedFree(ptr); }
+
+void operator delete[](void *ptr, size_t) noexcept { trackedFree(ptr); }
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { trackedFree(ptr); }
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { trackedFree(ptr); }
+
+void operator delete(void *ptr, std::align_val_t) noexcept { trackedFree(ptr); }
+
+void operator delete[](void *ptr, std::align_val_t) noexcept { trackedFree(ptr); }
+
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept { trackedFree(ptr); }
+
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept { trackedFree(ptr); }
+
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { trackedFree(ptr); }
+
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { trackedFree(ptr); }
+
+#endif
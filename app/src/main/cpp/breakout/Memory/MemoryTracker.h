@@ -0,0 +1,136 @@
+/*
+MIT License
+
+Copyright (c) 2023 Victor Falcon Zaro
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef _MEMORY_TRACKER_H_
+#define _MEMORY_TRACKER_H_
+
+#include <Common.h>
+#include <cstddef>
+
+//! Subsystems memory is accounted to
+enum class MemoryTag : u8
+{
+	General,
+	Scene,
+	Renderer,
+	Fonts,
+	Textures,
+	Count
+};
+
+//! Memory usage tracking per subsystem
+/*
+*	Heap usage is only recorded when built with BREAKOUT_MEMORY_TRACKING, which
+*	replaces the global new/delete operators. GPU memory is reported explicitly
+*	by the owners of the GL objects and is always tracked.
+*	Allocations are accounted to the tag of the innermost MemoryScope.
+*/
+namespace MemoryTracker
+{
+	//! Usage of a single tag
+	struct TagStats
+	{
+		u64 LiveBytes = 0; /**< Heap bytes currently allocated */
+		u64 PeakBytes = 0; /**< Highest heap bytes allocated at once */
+		u64 GpuBytes = 0; /**< GPU bytes currently allocated */
+		u64 PeakGpuBytes = 0; /**< Highest GPU bytes allocated at once */
+		u32 LiveAllocations = 0; /**< Heap blocks currently allocated */
+		u32 FrameAllocations = 0; /**< Heap blocks allocated during the last frame */
+	};
+
+	//! @return If heap allocations are being recorded
+	constexpr bool isHeapTrackingEnabled()
+	{
+#ifdef BREAKOUT_MEMORY_TRACKING
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	//! @return The tag new allocations are accounted to on this thread
+	NODISCARD MemoryTag getCurrentTag();
+
+	//! Sets the tag new allocations are accounted to on this thread, see MemoryScope
+	void setCurrentTag(MemoryTag tag);
+
+	void recordAllocation(MemoryTag tag, size_t size);
+
+	void recordFree(MemoryTag tag, size_t size);
+
+	void recordGpuAllocation(MemoryTag tag, size_t size);
+
+	void recordGpuFree(MemoryTag tag, size_t size);
+
+	//! Sets the heap budget of a tag, exceeding it asserts on debug builds
+	//! @param tag Subsystem
+	//! @param bytes Budget in bytes, 0 disables it
+	void setBudget(MemoryTag tag, u64 bytes);
+
+	//! Sets the GPU budget of a tag, exceeding it asserts on debug builds
+	//! @param tag Subsystem
+	//! @param bytes Budget in bytes, 0 disables it
+	void setGpuBudget(MemoryTag tag, u64 bytes);
+
+	NODISCARD TagStats getStats(MemoryTag tag);
+
+	//! @return Heap blocks allocated during the last frame, over all tags
+	NODISCARD u32 getFrameAllocations();
+
+	//! Closes the per frame counters
+	void endFrame();
+
+	//! Logs the usage of every tag
+	void dump();
+}
+
+//! Scoped memory tag
+/*
+*	Accounts every allocation done in its lifetime to the given tag
+*/
+class MemoryScope
+{
+public:
+	//! Constructor
+	//! @param tag Tag allocations are accounted to
+	explicit MemoryScope(MemoryTag tag)
+			: m_Previous(MemoryTracker::getCurrentTag())
+	{
+		MemoryTracker::setCurrentTag(tag);
+	}
+
+	//! Destructor
+	//! Restores the previous tag
+	~MemoryScope()
+	{
+		MemoryTracker::setCurrentTag(m_Previous);
+	}
+
+	DISABLE_MOVE_AND_COPY(MemoryScope)
+
+private:
+	MemoryTag m_Previous; /**< Tag active before the scope */
+};
+
+#endif
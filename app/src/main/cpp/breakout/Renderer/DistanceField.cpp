@@ -0,0 +1,96 @@
+#include "DistanceField.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    constexpr f32 c_Infinity = 1e20f;
+
+    //! 1D squared distance transform of Felzenszwalb and Huttenlocher, in place over a strided line
+    void transformLine(f32 *grid, u32 offset, u32 stride, u32 length,
+                       f32 *f, f32 *z, u32 *v) {
+        for (u32 q = 0; q < length; q++) {
+            f[q] = grid[offset + q * stride];
+        }
+
+        i32 k = 0;
+        v[0] = 0;
+        z[0] = -c_Infinity;
+        z[1] = c_Infinity;
+        for (u32 q = 1; q < length; q++) {
+            // Drop the parabolas hidden by the one rooted at q
+            f32 s;
+            do {
+                const u32 r = v[k];
+                s = (f[q] - f[r] + static_cast<f32>(q * q) - static_cast<f32>(r * r)) / static_cast<f32>(2 * (q - r));
+            } while (s <= z[k] && --k >= 0);
+
+            k++;
+            v[k] = q;
+            z[k] = s;
+            z[k + 1] = c_Infinity;
+        }
+
+        k = 0;
+        for (u32 q = 0; q < length; q++) {
+            while (z[k + 1] < static_cast<f32>(q)) {
+                k++;
+            }
+            const f32 distance = static_cast<f32>(q) - static_cast<f32>(v[k]);
+            grid[offset + q * stride] = distance * distance + f[v[k]];
+        }
+    }
+
+    void transform(std::vector<f32> &grid, u32 width, u32 height) {
+        const u32 length = std::max(width, height);
+        std::vector<f32> f(length);
+        std::vector<f32> z(length + 1);
+        std::vector<u32> v(length);
+
+        for (u32 x = 0; x < width; x++) {
+            transformLine(grid.data(), x, width, height, f.data(), z.data(), v.data());
+        }
+        for (u32 y = 0; y < height; y++) {
+            transformLine(grid.data(), y * width, 1, width, f.data(), z.data(), v.data());
+        }
+    }
+}
+
+namespace DistanceField {
+    std::vector<u8> generate(const u8 *coverage, u32 width, u32 height, u32 pitch, u32 spread) {
+        const u32 fieldWidth = width + spread * 2;
+        const u32 fieldHeight = height + spread * 2;
+        const size_t size = static_cast<size_t>(fieldWidth) * fieldHeight;
+
+        // Squared distances to the nearest inside and outside pixel, the border is outside
+        std::vector<f32> outer(size, c_Infinity);
+        std::vector<f32> inner(size, 0.0f);
+        for (u32 y = 0; y < height; y++) {
+            for (u32 x = 0; x < width; x++) {
+                const f32 a = coverage[y * pitch + x] / 255.0f;
+                const size_t index = (y + spread) * fieldWidth + x + spread;
+                if (a >= 1.0f) {
+                    outer[index] = 0.0f;
+                    inner[index] = c_Infinity;
+                } else if (a > 0.0f) {
+                    const f32 d = 0.5f - a;
+                    outer[index] = d > 0.0f ? d * d : 0.0f;
+                    inner[index] = d < 0.0f ? d * d : 0.0f;
+                }
+            }
+        }
+
+        transform(outer, fieldWidth, fieldHeight);
+        transform(inner, fieldWidth, fieldHeight);
+
+        std::vector<u8> field(size);
+        const f32 range = static_cast<f32>(spread) * 2.0f;
+        for (size_t i = 0; i < size; i++) {
+            const f32 distance = std::sqrt(outer[i]) - std::sqrt(inner[i]);
+            const f32 value = std::clamp(0.5f - distance / range, 0.0f, 1.0f);
+            field[i] = static_cast<u8>(std::lround(value * 255.0f));
+        }
+        return field;
+    }
+}
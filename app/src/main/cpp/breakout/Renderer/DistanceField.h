@@ -0,0 +1,28 @@
+#ifndef _DISTANCE_FIELD_H
+#define _DISTANCE_FIELD_H
+
+#include <vector>
+
+#include "Common.h"
+
+namespace DistanceField {
+    /*!
+     * Builds a signed distance field from an anti-aliased coverage bitmap, using exact euclidean
+     * distance transforms of the inside and the outside. The coverage of edge pixels gives the
+     * sub-pixel position of the edge.
+     *
+     * The field is 0.5 (127) on the edge, grows towards 1 inside and reaches 0 at @a spread pixels
+     * outside.
+     *
+     * @param coverage 8 bit coverage, 255 fully inside
+     * @param width width of the bitmap
+     * @param height height of the bitmap
+     * @param pitch bytes between two rows of the bitmap
+     * @param spread distance range encoded on each side of the edge, also the border added around
+     * the bitmap
+     * @return a (width + 2 * spread) x (height + 2 * spread) field
+     */
+    std::vector<u8> generate(const u8 *coverage, u32 width, u32 height, u32 pitch, u32 spread);
+}
+
+#endif //_DISTANCE_FIELD_H
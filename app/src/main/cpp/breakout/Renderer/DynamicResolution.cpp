@@ -0,0 +1,54 @@
+#include "DynamicResolution.h"
+
+#include <algorithm>
+
+/*!
+ * Weight of the last frame in the smoothed frame time
+ */
+static constexpr f32 kSmoothing = 0.2f;
+
+DynamicResolution::DynamicResolution(const Settings &settings)
+        : m_Settings(settings), m_Scale(settings.MaxScale) {}
+
+bool DynamicResolution::update(f32 frameMs) {
+    if (!m_Enabled) {
+        return false;
+    }
+
+    m_AverageMs = m_AverageMs == 0.0f ? frameMs : m_AverageMs + (frameMs - m_AverageMs) * kSmoothing;
+
+    if (m_SettleFrames > 0) {
+        m_SettleFrames--;
+        return false;
+    }
+
+    const f32 previous = m_Scale;
+    if (m_AverageMs > m_Settings.BudgetMs * m_Settings.DropThreshold) {
+        m_Scale = std::max(m_Settings.MinScale, m_Scale - m_Settings.Step);
+        m_FramesWithinBudget = 0;
+    } else if (m_AverageMs < m_Settings.BudgetMs * m_Settings.RaiseThreshold) {
+        if (++m_FramesWithinBudget >= m_Settings.RaiseFrames) {
+            m_Scale = std::min(m_Settings.MaxScale, m_Scale + m_Settings.Step);
+            m_FramesWithinBudget = 0;
+        }
+    } else {
+        m_FramesWithinBudget = 0;
+    }
+
+    if (m_Scale == previous) {
+        return false;
+    }
+    m_SettleFrames = m_Settings.SettleFrames;
+    // Start the new scale from the budget instead of the frames rendered at the old one
+    m_AverageMs = m_Settings.BudgetMs;
+    return true;
+}
+
+void DynamicResolution::setEnabled(bool enabled) {
+    m_Enabled = enabled;
+    if (!enabled) {
+        m_Scale = m_Settings.MaxScale;
+    }
+    m_FramesWithinBudget = 0;
+    m_SettleFrames = 0;
+}
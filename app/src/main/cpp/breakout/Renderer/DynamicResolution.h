@@ -0,0 +1,64 @@
+#ifndef _DYNAMIC_RESOLUTION_H
+#define _DYNAMIC_RESOLUTION_H
+
+#include "Common.h"
+
+/*!
+ * Picks the render resolution scale from the measured frame time. The scale drops as soon as frames
+ * run over budget, and only rises again after a long run of frames within budget, so it doesn't
+ * oscillate around the threshold.
+ */
+class DynamicResolution {
+public:
+    struct Settings {
+        // Frame time to hold, 60Hz by default
+        f32 BudgetMs = 1000.0f / 60.0f;
+        f32 MinScale = 0.5f;
+        f32 MaxScale = 1.0f;
+        f32 Step = 0.1f;
+        // Frames above this fraction of the budget lower the scale
+        f32 DropThreshold = 1.15f;
+        // Frames below this fraction of the budget count towards raising the scale, low enough that
+        // the frame still fits once the scale goes up a step
+        f32 RaiseThreshold = 0.8f;
+        // Consecutive frames within budget needed to raise the scale
+        u32 RaiseFrames = 120;
+        // Frames ignored after a change, the new scale needs time to show in the timings
+        u32 SettleFrames = 10;
+    };
+
+    DynamicResolution() = default;
+
+    explicit DynamicResolution(const Settings &settings);
+
+    /*!
+     * Feeds the duration of the last frame
+     * @param frameMs work time of the last frame without the vsync wait, in milliseconds
+     * @return true if the scale changed
+     */
+    bool update(f32 frameMs);
+
+    /*!
+     * @return the fraction of the window resolution to render at
+     */
+    f32 getScale() const { return m_Scale; }
+
+    /*!
+     * @return the smoothed frame time the decisions are based on
+     */
+    f32 getAverageMs() const { return m_AverageMs; }
+
+    void setEnabled(bool enabled);
+
+    bool isEnabled() const { return m_Enabled; }
+
+private:
+    Settings m_Settings;
+    f32 m_Scale = 1.0f;
+    f32 m_AverageMs = 0.0f;
+    u32 m_FramesWithinBudget = 0;
+    u32 m_SettleFrames = 0;
+    bool m_Enabled = true;
+};
+
+#endif //_DYNAMIC_RESOLUTION_H
@@ -2,6 +2,9 @@
 
 #include "Fonts.h"
 #include "Core/AndroidOut.h"
+#include "Memory/MemoryTracker.h"
+#include "DistanceField.h"
+#include "RectPacker.h"
 #include <FileSystem/FileSystem.h>
 #include <filesystem>
 
@@ -31,10 +34,34 @@ uniform vec3 uColor;
 out vec4 outColor;
 
 void main() {
-    vec4 sampled = vec4(1.0, 1.0, 1.0, texture(uTexture, fragUV).r);
-    outColor = vec4(uColor, 1.0) * sampled;
+    // The edge sits at 0.5, smooth over about a pixel whatever the scale
+    float distance = texture(uTexture, fragUV).r;
+    float width = fwidth(distance);
+    float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+    outColor = vec4(uColor, alpha);
 }
 )fragment";
+
+/*!
+ * Pixel size glyphs are rasterized at before building their distance field
+ */
+static constexpr u32 kRasterSize = 32;
+
+/*!
+ * Distance range encoded around the glyph edges, in raster pixels
+ */
+static constexpr u32 kSpread = 4;
+
+/*!
+ * Width and height of a glyph atlas page
+ */
+static constexpr u32 kAtlasSize = 512;
+
+/*!
+ * Pages kept at most, this bounds the font GPU memory to kMaxPages * kAtlasSize^2 bytes
+ */
+static constexpr u32 kMaxPages = 4;
+
 const char* getErrorMessage(FT_Error err)
 {
 #undef FTERRORS_H_
@@ -58,68 +85,188 @@ void Fonts::initialize() {
 }
 
 Fonts::~Fonts() {
+    for (const auto &page: m_Pages) {
+        MemoryTracker::recordGpuFree(MemoryTag::Fonts, kAtlasSize * kAtlasSize);
+        GLState::deleteTexture(page.Texture);
+    }
+    if (m_Face) {
+        FT_Done_Face(m_Face);
+    }
     FT_Done_FreeType(m_Library);
 }
 
 void Fonts::loadFont(const std::string &path) {
+    MemoryScope memoryScope(MemoryTag::Fonts);
 
-
-    FT_Face face;
     FILE *f = android_fopen(path.c_str(), "r");
     fseek(f, 0, SEEK_END);
     long fsize = ftell(f);
     fseek(f, 0, SEEK_SET);  /* same as rewind(f); */
 
-    char *string = new char[fsize + 1];
-    fread(string, fsize, 1, f);
+    std::vector<FT_Byte> data(fsize);
+    fread(data.data(), fsize, 1, f);
     fclose(f);
-    string[fsize] = 0;
 
-    if (FT_Error error = FT_New_Memory_Face(m_Library, (FT_Byte*)string, fsize, 0, &face)) {
+    FT_Face face;
+    if (FT_Error error = FT_New_Memory_Face(m_Library, data.data(), fsize, 0, &face)) {
         aout << "ERROR::FREETYPE: Failed to load font: " << getErrorMessage(error) << std::endl;
         return;
     }
 
-    FT_Set_Pixel_Sizes(face, 0, 48);
+    // Glyphs are rasterized on demand, so the face and its data stay alive
+    if (m_Face) {
+        FT_Done_Face(m_Face);
+    }
+    m_Face = face;
+    m_FontData = std::move(data);
+    FT_Set_Pixel_Sizes(m_Face, 0, kRasterSize);
 
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    for (ubyte c = 0; c < 128; c++) {
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-            aout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
-            continue;
+    // Cached glyphs belong to the previous font
+    m_Characters.clear();
+    for (auto &page: m_Pages) {
+        page.Packer.clear();
+    }
+    m_Generation++;
+}
+
+const Character *Fonts::getCharacter(char32_t codepoint) {
+    const auto it = m_Characters.find(codepoint);
+    if (it != m_Characters.end()) {
+        if (it->second.Page != kNoPage) {
+            markUsed(it->second.Page);
         }
+        return &it->second;
+    }
+
+    if (!m_Face) {
+        return nullptr;
+    }
+
+    MemoryScope memoryScope(MemoryTag::Fonts);
+    if (FT_Load_Char(m_Face, codepoint, FT_LOAD_RENDER)) {
+        aout << "ERROR::FREETYTPE: Failed to load Glyph " << static_cast<u32>(codepoint) << std::endl;
+        return nullptr;
+    }
+
+    // Metrics are rasterized small, scale them to text units
+    constexpr f32 scale = static_cast<f32>(kFontSize) / kRasterSize;
+    constexpr f32 atlasSize = kAtlasSize;
 
-        u32 texture;
+    const FT_Bitmap &bitmap = m_Face->glyph->bitmap;
+    const u32 width = bitmap.width + kSpread * 2;
+    const u32 height = bitmap.rows + kSpread * 2;
+
+    Character character = {
+            kNoPage,
+            V4{0.0f},
+            V2{static_cast<f32>(width), static_cast<f32>(height)} * scale,
+            V2{static_cast<f32>(m_Face->glyph->bitmap_left) - kSpread,
+               static_cast<f32>(m_Face->glyph->bitmap_top) + kSpread} * scale,
+            static_cast<f32>(m_Face->glyph->advance.x) / 64.0f * scale
+    };
+
+    if (bitmap.width > 0 && bitmap.rows > 0) {
+        // One texel of space between glyphs so filtering doesn't pick the neighbours up
+        u32 x = 0;
+        u32 y = 0;
+        const u32 page = allocate(width + 1, height + 1, x, y);
+        if (page == kNoPage) {
+            aout << "ERROR::FREETYTPE: Glyph atlas is full" << std::endl;
+            return nullptr;
+        }
+
+        const auto field = DistanceField::generate(bitmap.buffer, bitmap.width, bitmap.rows, bitmap.pitch, kSpread);
+        GLState::bindTexture(m_Pages[page].Texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RED, GL_UNSIGNED_BYTE, field.data());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        character.Page = page;
+        character.UVRect = V4{x / atlasSize, y / atlasSize, width / atlasSize, height / atlasSize};
+        markUsed(page);
+    }
+
+    return &m_Characters.emplace(codepoint, character).first->second;
+}
+
+f32 Fonts::getKerning(char32_t left, char32_t right) const {
+    if (!m_Face || !FT_HAS_KERNING(m_Face)) {
+        return 0.0f;
+    }
+
+    FT_Vector delta;
+    if (FT_Get_Kerning(m_Face, FT_Get_Char_Index(m_Face, left), FT_Get_Char_Index(m_Face, right),
+                       FT_KERNING_DEFAULT, &delta)) {
+        return 0.0f;
+    }
+    return static_cast<f32>(delta.x) / 64.0f * kFontSize / kRasterSize;
+}
+
+f32 Fonts::getLineHeight() const {
+    if (!m_Face) {
+        return static_cast<f32>(kFontSize);
+    }
+    return static_cast<f32>(m_Face->size->metrics.height) / 64.0f * kFontSize / kRasterSize;
+}
+
+u32 Fonts::allocate(u32 width, u32 height, u32 &x, u32 &y) {
+    for (u32 page = 0; page < m_Pages.size(); page++) {
+        if (m_Pages[page].Packer.pack(width, height, x, y)) {
+            return page;
+        }
+    }
+
+    if (m_Pages.size() < kMaxPages) {
+        GLuint texture;
         glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(
-                GL_TEXTURE_2D,
-                0,
-                GL_RED,
-                face->glyph->bitmap.width,
-                face->glyph->bitmap.rows,
-                0,
-                GL_RED,
-                GL_UNSIGNED_BYTE,
-                face->glyph->bitmap.buffer
-        );
+        GLState::bindTexture(texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, kAtlasSize, kAtlasSize, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+        MemoryTracker::recordGpuAllocation(MemoryTag::Fonts, kAtlasSize * kAtlasSize);
         // set texture options
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        // now store character for later use
-        Character character = {
-                texture,
-                glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-                glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-                static_cast<u32>(face->glyph->advance.x)
-        };
-        m_Characters.insert(std::pair<char, Character>(c, character));
+
+        m_Pages.push_back(Page{texture, RectPacker(kAtlasSize, kAtlasSize), m_Frame});
+        const u32 page = m_Pages.size() - 1;
+        if (m_Pages.size() == kMaxPages) {
+            // From now on pages get evicted, keep the data that clears them
+            m_ClearData.assign(kAtlasSize * kAtlasSize, 0);
+        }
+        return m_Pages[page].Packer.pack(width, height, x, y) ? page : kNoPage;
     }
 
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    // Reuse the least recently drawn page, pages drawn this frame are still referenced by the queue
+    u32 oldest = kNoPage;
+    for (u32 page = 0; page < m_Pages.size(); page++) {
+        if (m_Pages[page].LastUsed < m_Frame
+            && (oldest == kNoPage || m_Pages[page].LastUsed < m_Pages[oldest].LastUsed)) {
+            oldest = page;
+        }
+    }
+    if (oldest == kNoPage) {
+        return kNoPage;
+    }
 
-    FT_Done_Face(face);
-    delete[] string;
+    evict(oldest);
+    return m_Pages[oldest].Packer.pack(width, height, x, y) ? oldest : kNoPage;
+}
+
+void Fonts::evict(u32 page) {
+    for (auto it = m_Characters.begin(); it != m_Characters.end();) {
+        if (it->second.Page == page) {
+            it = m_Characters.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_Pages[page].Packer.clear();
+    m_Generation++;
+
+    // Clear the old glyphs, the new ones don't leave the same gaps
+    GLState::bindTexture(m_Pages[page].Texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, kAtlasSize, kAtlasSize, GL_RED, GL_UNSIGNED_BYTE, m_ClearData.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 }
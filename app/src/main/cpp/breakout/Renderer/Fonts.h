@@ -4,31 +4,114 @@
 #include "Common.h"
 #include "TextureAsset.h"
 #include "Math/MathTypes.h"
-#include <map>
+#include <unordered_map>
+#include <vector>
 #include "Shader.h"
+#include "RectPacker.h"
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+/*!
+ * Glyph metrics in text units, the pixel size at which text is laid out (@a Fonts::kFontSize).
+ * Size and Bearing cover the distance field border, not just the outline.
+ */
 struct Character{
-    u32 TextureID;
-    Iv2 Size;
-    Iv2 Bearing;
-    u32 Advance;
+    // Atlas page holding the glyph, Fonts::kNoPage for glyphs with nothing to draw (spaces)
+    u32 Page;
+    V4 UVRect;
+    V2 Size;
+    V2 Bearing;
+    f32 Advance;
 };
 
+/*!
+ * Glyphs are stored as signed distance fields in atlas pages, so one small rasterization renders
+ * sharp at any scale. Codepoints are rasterized the first time they are asked for. Once every page
+ * is full, the page least recently drawn is emptied for the new glyphs, which bumps the generation
+ * so layouts referencing it get rebuilt.
+ */
 class Fonts {
 public:
+    //! Pixel size the text metrics are expressed in
+    static constexpr u32 kFontSize = 48;
+    //! Page of glyphs without a quad
+    static constexpr u32 kNoPage = ~0u;
+
     Fonts() = default;
     ~Fonts();
 
+    DISABLE_MOVE_AND_COPY(Fonts)
+
     void initialize();
     void loadFont(const std::string& path);
 
+    /*!
+     * Returns the glyph of a codepoint, rasterizing it if needed. The page of the glyph is marked
+     * as used this frame.
+     * @param codepoint unicode codepoint
+     * @return the glyph, null if it couldn't be loaded
+     */
+    const Character *getCharacter(char32_t codepoint);
+
+    /*!
+     * @return the horizontal adjustment between two codepoints in text units, 0 without kerning
+     */
+    f32 getKerning(char32_t left, char32_t right) const;
+
+    /*!
+     * @return the distance between two baselines in text units
+     */
+    f32 getLineHeight() const;
+
+    /*!
+     * Keeps a page from being evicted this frame, call for every page drawn
+     */
+    void markUsed(u32 page) { m_Pages[page].LastUsed = m_Frame; }
+
+    GLuint getPageTexture(u32 page) const { return m_Pages[page].Texture; }
+
+    /*!
+     * @return a counter changed every time glyphs are evicted, layouts built with another value
+     * are stale
+     */
+    u32 getGeneration() const { return m_Generation; }
+
+    /*!
+     * Starts a new frame for the page usage tracking
+     */
+    void endFrame() { m_Frame++; }
+
 private:
-    std::map<char, Character> m_Characters;
+    struct Page {
+        GLuint Texture;
+        RectPacker Packer;
+        // Last frame a glyph of the page was drawn or laid out
+        u64 LastUsed;
+    };
+
+    /*!
+     * Finds room for a glyph, creating or evicting a page if needed
+     * @return the page, kNoPage if every page is in use this frame
+     */
+    u32 allocate(u32 width, u32 height, u32 &x, u32 &y);
+
+    /*!
+     * Drops every glyph of a page so it can be reused
+     */
+    void evict(u32 page);
+
+    std::unordered_map<char32_t, Character> m_Characters;
+    std::vector<Page> m_Pages;
+    // Zeros uploaded over an evicted page, allocated once every page exists
+    std::vector<u8> m_ClearData;
     std::unique_ptr<Shader> m_Shader;
     FT_Library m_Library;
+    // FreeType reads the font from this buffer for as long as the face lives
+    std::vector<FT_Byte> m_FontData;
+    FT_Face m_Face = nullptr;
+    u64 m_Frame = 1;
+    u32 m_Generation = 0;
     friend class Renderer;
 };
 
@@ -0,0 +1,158 @@
+#include "GLState.h"
+#include "Core/AndroidOut.h"
+
+namespace GLState {
+    namespace {
+        // Attribute arrays tracked for the default vertex array object
+        constexpr GLuint c_MaxAttributes = 16;
+
+        GLuint g_Program = 0;
+        GLuint g_Texture = 0;
+        GLuint g_ArrayBuffer = 0;
+        u32 g_EnabledAttributes = 0;
+        bool g_Valid = false;
+
+        Stats g_Stats;
+        Stats g_FrameStats;
+        Stats g_LastFrameStats;
+
+        void accumulate(Stats &total, const Stats &frame) {
+            total.ProgramBinds += frame.ProgramBinds;
+            total.ProgramBindsSkipped += frame.ProgramBindsSkipped;
+            total.TextureBinds += frame.TextureBinds;
+            total.TextureBindsSkipped += frame.TextureBindsSkipped;
+            total.AttributeToggles += frame.AttributeToggles;
+            total.AttributeTogglesSkipped += frame.AttributeTogglesSkipped;
+        }
+
+        void revalidate() {
+            if (g_Valid) {
+                return;
+            }
+
+            GLint program = 0;
+            glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+            g_Program = program;
+
+            glActiveTexture(GL_TEXTURE0);
+            GLint texture = 0;
+            glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture);
+            g_Texture = texture;
+
+            GLint arrayBuffer = 0;
+            glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &arrayBuffer);
+            g_ArrayBuffer = arrayBuffer;
+
+            g_EnabledAttributes = 0;
+            for (GLuint i = 0; i < c_MaxAttributes; i++) {
+                GLint enabled = GL_FALSE;
+                glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &enabled);
+                if (enabled) {
+                    g_EnabledAttributes |= 1u << i;
+                }
+            }
+            g_Valid = true;
+        }
+    }
+
+    void invalidate() {
+        g_Valid = false;
+    }
+
+    void useProgram(GLuint program) {
+        revalidate();
+        if (g_Program == program) {
+            g_FrameStats.ProgramBindsSkipped++;
+            return;
+        }
+        glUseProgram(program);
+        g_Program = program;
+        g_FrameStats.ProgramBinds++;
+    }
+
+    void bindTexture(GLuint texture) {
+        revalidate();
+        if (g_Texture == texture) {
+            g_FrameStats.TextureBindsSkipped++;
+            return;
+        }
+        glBindTexture(GL_TEXTURE_2D, texture);
+        g_Texture = texture;
+        g_FrameStats.TextureBinds++;
+    }
+
+    void bindArrayBuffer(GLuint buffer) {
+        revalidate();
+        if (g_ArrayBuffer == buffer) {
+            return;
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        g_ArrayBuffer = buffer;
+    }
+
+    void enableVertexAttribArray(GLuint index) {
+        revalidate();
+        const u32 bit = 1u << index;
+        if (index < c_MaxAttributes && (g_EnabledAttributes & bit)) {
+            g_FrameStats.AttributeTogglesSkipped++;
+            return;
+        }
+        glEnableVertexAttribArray(index);
+        g_EnabledAttributes |= bit;
+        g_FrameStats.AttributeToggles++;
+    }
+
+    void disableVertexAttribArray(GLuint index) {
+        revalidate();
+        const u32 bit = 1u << index;
+        if (index < c_MaxAttributes && !(g_EnabledAttributes & bit)) {
+            g_FrameStats.AttributeTogglesSkipped++;
+            return;
+        }
+        glDisableVertexAttribArray(index);
+        g_EnabledAttributes &= ~bit;
+        g_FrameStats.AttributeToggles++;
+    }
+
+    void deleteTexture(GLuint texture) {
+        glDeleteTextures(1, &texture);
+        if (g_Texture == texture) {
+            g_Texture = 0;
+        }
+    }
+
+    void deleteBuffer(GLuint buffer) {
+        glDeleteBuffers(1, &buffer);
+        if (g_ArrayBuffer == buffer) {
+            g_ArrayBuffer = 0;
+        }
+    }
+
+    void deleteProgram(GLuint program) {
+        glDeleteProgram(program);
+        if (g_Program == program) {
+            g_Program = 0;
+        }
+    }
+
+    const Stats &getStats() {
+        return g_Stats;
+    }
+
+    const Stats &getFrameStats() {
+        return g_LastFrameStats;
+    }
+
+    void endFrame() {
+        accumulate(g_Stats, g_FrameStats);
+        g_LastFrameStats = g_FrameStats;
+        g_FrameStats = Stats();
+    }
+
+    void dump() {
+        aout << "GL state changes issued/skipped: programs " << g_Stats.ProgramBinds << "/"
+             << g_Stats.ProgramBindsSkipped << ", textures " << g_Stats.TextureBinds << "/"
+             << g_Stats.TextureBindsSkipped << ", attributes " << g_Stats.AttributeToggles << "/"
+             << g_Stats.AttributeTogglesSkipped << std::endl;
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef _GL_STATE_H
+#define _GL_STATE_H
+
+#include <GLES3/gl3.h>
+#include "Common.h"
+
+/*!
+ * Cache of the GL state touched by the renderer. Every bind goes through here so calls that would
+ * not change anything are skipped. Anything binding GL state directly must call @a invalidate
+ * afterwards.
+ */
+namespace GLState {
+    /*!
+     * Counters of the state changes issued and skipped
+     */
+    struct Stats {
+        u32 ProgramBinds = 0;
+        u32 ProgramBindsSkipped = 0;
+        u32 TextureBinds = 0;
+        u32 TextureBindsSkipped = 0;
+        u32 AttributeToggles = 0;
+        u32 AttributeTogglesSkipped = 0;
+    };
+
+    /*!
+     * Forgets the cached state, call after creating a context or touching GL state directly
+     */
+    void invalidate();
+
+    void useProgram(GLuint program);
+
+    /*!
+     * Binds a 2D texture to the texture unit 0, the only unit the renderer uses
+     */
+    void bindTexture(GLuint texture);
+
+    /*!
+     * Binds a buffer to GL_ARRAY_BUFFER. Client side vertex arrays need 0 bound
+     */
+    void bindArrayBuffer(GLuint buffer);
+
+    void enableVertexAttribArray(GLuint index);
+
+    void disableVertexAttribArray(GLuint index);
+
+    /*!
+     * Deletes a texture, forgetting it if it is the cached binding so a reused name gets rebound
+     */
+    void deleteTexture(GLuint texture);
+
+    /*!
+     * Deletes a buffer, forgetting it if it is the cached array buffer so a reused name gets rebound
+     */
+    void deleteBuffer(GLuint buffer);
+
+    /*!
+     * Deletes a program, forgetting it if it is the cached one so a reused name gets rebound
+     */
+    void deleteProgram(GLuint program);
+
+    /*!
+     * @return counters accumulated since startup
+     */
+    const Stats &getStats();
+
+    /*!
+     * @return counters of the last finished frame
+     */
+    const Stats &getFrameStats();
+
+    /*!
+     * Closes the per frame counters
+     */
+    void endFrame();
+
+    /*!
+     * Logs the accumulated counters
+     */
+    void dump();
+}
+
+#endif //_GL_STATE_H
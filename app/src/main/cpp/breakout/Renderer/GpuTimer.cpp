@@ -0,0 +1,70 @@
+#include "GpuTimer.h"
+
+#include <GLES2/gl2ext.h>
+#include <cstring>
+
+GpuTimer::~GpuTimer() {
+    destroy();
+}
+
+void GpuTimer::initialize() {
+    const auto *extensions = reinterpret_cast<const char *>(glGetString(GL_EXTENSIONS));
+    m_Supported = extensions && strstr(extensions, "GL_EXT_disjoint_timer_query");
+    if (m_Supported) {
+        glGenQueries(kQueryCount, m_Queries);
+        m_Next = 0;
+        m_Pending = 0;
+    }
+}
+
+void GpuTimer::destroy() {
+    if (m_Supported) {
+        glDeleteQueries(kQueryCount, m_Queries);
+        m_Supported = false;
+    }
+}
+
+void GpuTimer::begin() {
+    if (!m_Supported || m_Pending == kQueryCount) {
+        return;
+    }
+    glBeginQuery(GL_TIME_ELAPSED_EXT, m_Queries[m_Next]);
+    m_Active = true;
+}
+
+void GpuTimer::end() {
+    if (!m_Active) {
+        return;
+    }
+    glEndQuery(GL_TIME_ELAPSED_EXT);
+    m_Next = (m_Next + 1) % kQueryCount;
+    m_Pending++;
+    m_Active = false;
+}
+
+bool GpuTimer::poll(f32 &ms) {
+    if (!m_Supported) {
+        return false;
+    }
+
+    bool read = false;
+    while (m_Pending > 0) {
+        const GLuint query = m_Queries[(m_Next + kQueryCount - m_Pending) % kQueryCount];
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+
+        GLuint nanoseconds = 0;
+        glGetQueryObjectuiv(query, GL_QUERY_RESULT, &nanoseconds);
+        m_Pending--;
+        ms = static_cast<f32>(nanoseconds) / 1.0e6f;
+        read = true;
+    }
+
+    // Results spanning a disjoint event (power state change, context loss) are meaningless
+    GLint disjoint = 0;
+    glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+    return read && !disjoint;
+}
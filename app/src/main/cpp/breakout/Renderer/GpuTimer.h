@@ -0,0 +1,58 @@
+#ifndef _GPU_TIMER_H
+#define _GPU_TIMER_H
+
+#include <GLES3/gl3.h>
+
+#include "Common.h"
+
+/*!
+ * Measures the GPU time of a span of GL commands with GL_EXT_disjoint_timer_query. Results arrive a
+ * few frames late, a small ring of queries is polled so reading them never stalls the pipeline.
+ * Does nothing on drivers without the extension.
+ */
+class GpuTimer {
+public:
+    GpuTimer() = default;
+
+    ~GpuTimer();
+
+    DISABLE_MOVE_AND_COPY(GpuTimer)
+
+    /*!
+     * Creates the queries if the extension is available, needs a current context
+     */
+    void initialize();
+
+    /*!
+     * Deletes the queries, needs the context they were created with
+     */
+    void destroy();
+
+    /*!
+     * Starts timing, skipped while every query is still waiting for its result
+     */
+    void begin();
+
+    void end();
+
+    /*!
+     * Reads the results that are ready
+     * @param ms receives the newest GPU time, in milliseconds
+     * @return true if a new result was read
+     */
+    bool poll(f32 &ms);
+
+    bool isSupported() const { return m_Supported; }
+
+private:
+    static constexpr u32 kQueryCount = 4;
+
+    GLuint m_Queries[kQueryCount] = {};
+    // Next query to start, and how many started ones haven't been read yet
+    u32 m_Next = 0;
+    u32 m_Pending = 0;
+    bool m_Supported = false;
+    bool m_Active = false;
+};
+
+#endif //_GPU_TIMER_H
@@ -0,0 +1,133 @@
+#include "InstancedSprites.h"
+
+#include <cstddef>
+
+#include "Core/AndroidOut.h"
+#include "Model.h"
+
+// Attribute locations are fixed so the vertex array can be set up once
+static const char *vertex = R"vertex(#version 300 es
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec2 inUV;
+layout(location = 2) in vec3 inInstancePosition;
+layout(location = 3) in vec2 inInstanceScale;
+layout(location = 4) in vec3 inInstanceColor;
+layout(location = 5) in vec4 inInstanceAtlasRect;
+
+out vec2 fragUV;
+out vec3 fragColor;
+
+uniform mat4 uProjection;
+
+void main() {
+    fragUV = inInstanceAtlasRect.xy + inUV * inInstanceAtlasRect.zw;
+    fragColor = inInstanceColor;
+    gl_Position = uProjection * vec4(inInstancePosition + vec3(inPosition.xy * inInstanceScale, 0.0), 1.0);
+}
+)vertex";
+
+static const char *fragment = R"fragment(#version 300 es
+precision mediump float;
+
+in vec2 fragUV;
+in vec3 fragColor;
+
+uniform sampler2D uTexture;
+
+out vec4 outColor;
+
+void main() {
+    outColor = vec4(fragColor, 1.0) * texture(uTexture, fragUV);
+}
+)fragment";
+
+static constexpr GLuint kPositionLocation = 0;
+static constexpr GLuint kUVLocation = 1;
+static constexpr GLuint kInstancePositionLocation = 2;
+static constexpr GLuint kInstanceScaleLocation = 3;
+static constexpr GLuint kInstanceColorLocation = 4;
+static constexpr GLuint kInstanceAtlasRectLocation = 5;
+
+InstancedSprites::~InstancedSprites() {
+    if (m_VertexArray) {
+        glDeleteVertexArrays(1, &m_VertexArray);
+        glDeleteBuffers(1, &m_QuadBuffer);
+        glDeleteBuffers(1, &m_IndexBuffer);
+    }
+}
+
+bool InstancedSprites::initialize(const Model &quad) {
+    m_Shader = std::unique_ptr<Shader>(
+            Shader::loadShader(vertex, fragment, "inPosition", "inUV", "uProjection", "uModel", "uColor"));
+    if (!m_Shader) {
+        aout << "Error: Couldn't create the instanced sprite shader" << std::endl;
+        return false;
+    }
+
+    glGenVertexArrays(1, &m_VertexArray);
+    glGenBuffers(1, &m_QuadBuffer);
+    glGenBuffers(1, &m_IndexBuffer);
+
+    // The vertex array keeps its own attribute state, GLState only tracks the default one
+    glBindVertexArray(m_VertexArray);
+
+    GLState::bindArrayBuffer(m_QuadBuffer);
+    glBufferData(GL_ARRAY_BUFFER, quad.getVertexCount() * sizeof(Vertex), quad.getVertexData(), GL_STATIC_DRAW);
+    glVertexAttribPointer(kPositionLocation, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), nullptr);
+    glEnableVertexAttribArray(kPositionLocation);
+    glVertexAttribPointer(kUVLocation, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                          reinterpret_cast<const void *>(sizeof(Vector3)));
+    glEnableVertexAttribArray(kUVLocation);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IndexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, quad.getIndexCount() * sizeof(Index), quad.getIndexData(), GL_STATIC_DRAW);
+    m_IndexCount = quad.getIndexCount();
+
+    // Instance attributes advance once per instance, their pointers are set on draw
+    for (const GLuint location: {kInstancePositionLocation, kInstanceScaleLocation,
+                                 kInstanceColorLocation, kInstanceAtlasRectLocation}) {
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+
+    glBindVertexArray(0);
+    // Client side arrays need the array buffer unbound
+    GLState::bindArrayBuffer(0);
+    return true;
+}
+
+void InstancedSprites::setProjectionMatrix(const Mat4 &projection) const {
+    m_Shader->activate();
+    m_Shader->setProjectionMatrix(projection);
+}
+
+void InstancedSprites::draw(const SpriteInstance *instances, u32 count, GLuint texture) {
+    if (count == 0) {
+        return;
+    }
+
+    m_Shader->activate();
+    GLState::bindTexture(texture);
+
+    glBindVertexArray(m_VertexArray);
+
+    const GLintptr offset = m_Instances.write(instances, count * sizeof(SpriteInstance), alignof(SpriteInstance));
+    if (offset < 0) {
+        glBindVertexArray(0);
+        return;
+    }
+
+    // The ring buffer is bound by the write, point the instance attributes at this batch
+    const auto setInstanceAttribute = [offset](GLuint location, GLint size, size_t member) {
+        glVertexAttribPointer(location, size, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+                              reinterpret_cast<const void *>(offset + member));
+    };
+    setInstanceAttribute(kInstancePositionLocation, 3, offsetof(SpriteInstance, Position));
+    setInstanceAttribute(kInstanceScaleLocation, 2, offsetof(SpriteInstance, Scale));
+    setInstanceAttribute(kInstanceColorLocation, 3, offsetof(SpriteInstance, Color));
+    setInstanceAttribute(kInstanceAtlasRectLocation, 4, offsetof(SpriteInstance, AtlasRect));
+
+    glDrawElementsInstanced(GL_TRIANGLES, m_IndexCount, GL_UNSIGNED_SHORT, nullptr, count);
+
+    glBindVertexArray(0);
+}
@@ -0,0 +1,76 @@
+#ifndef _INSTANCED_SPRITES_H
+#define _INSTANCED_SPRITES_H
+
+#include <memory>
+#include <GLES3/gl3.h>
+
+#include "Common.h"
+#include "Math/MathTypes.h"
+#include "Shader.h"
+#include "StreamBuffer.h"
+
+class Model;
+
+/*!
+ * Per instance data of a sprite drawn through @a InstancedSprites
+ */
+struct SpriteInstance {
+    // Center of the quad, the translation of the sprite transform
+    V3 Position;
+    // Half extents of the quad, the unit quad goes from -1 to 1
+    V2 Scale;
+    V3 Color;
+    // Region of the texture to sample as offset (xy) and size (zw) in UV space
+    V4 AtlasRect;
+};
+
+/*!
+ * Sprite backend drawing the unit quad once per texture with glDrawElementsInstanced. The
+ * instance attributes are streamed through a ring buffer. Rotation is not supported,
+ * instances are always axis aligned.
+ */
+class InstancedSprites {
+public:
+    InstancedSprites() = default;
+
+    ~InstancedSprites();
+
+    DISABLE_MOVE_AND_COPY(InstancedSprites)
+
+    /*!
+     * Creates the shader and the GL buffers
+     * @param quad unit quad to instance
+     * @return true on success
+     */
+    bool initialize(const Model &quad);
+
+    void setProjectionMatrix(const Mat4 &projection) const;
+
+    /*!
+     * Draws a batch of sprites sharing a texture
+     * @param instances per instance data, read during the call
+     * @param count amount of instances
+     * @param texture GL name of the texture to sample
+     */
+    void draw(const SpriteInstance *instances, u32 count, GLuint texture);
+
+    /*!
+     * Releases the instance data of the frame to the ring buffer, call after the draws are issued
+     */
+    void endFrame() { m_Instances.endFrame(); }
+
+    /*!
+     * @return the shader used by the batches
+     */
+    const Shader *getShader() const { return m_Shader.get(); }
+
+private:
+    std::unique_ptr<Shader> m_Shader;
+    GLuint m_VertexArray = 0;
+    GLuint m_QuadBuffer = 0;
+    GLuint m_IndexBuffer = 0;
+    StreamBuffer m_Instances{GL_ARRAY_BUFFER, 64 * 1024};
+    GLsizei m_IndexCount = 0;
+};
+
+#endif //_INSTANCED_SPRITES_H
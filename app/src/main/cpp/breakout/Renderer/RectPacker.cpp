@@ -0,0 +1,36 @@
+#include "RectPacker.h"
+
+RectPacker::RectPacker(u32 width, u32 height) : m_Width(width), m_Height(height) {}
+
+bool RectPacker::pack(u32 width, u32 height, u32 &x, u32 &y) {
+    if (width > m_Width || height > m_Height) {
+        return false;
+    }
+
+    // Pick the shelf wasting the least height
+    Shelf *best = nullptr;
+    for (auto &shelf: m_Shelves) {
+        if (shelf.Height >= height && m_Width - shelf.Used >= width
+            && (!best || shelf.Height < best->Height)) {
+            best = &shelf;
+        }
+    }
+
+    if (!best) {
+        if (m_Height - m_Bottom < height) {
+            return false;
+        }
+        best = &m_Shelves.emplace_back(Shelf{m_Bottom, height, 0});
+        m_Bottom += height;
+    }
+
+    x = best->Used;
+    y = best->Y;
+    best->Used += width;
+    return true;
+}
+
+void RectPacker::clear() {
+    m_Shelves.clear();
+    m_Bottom = 0;
+}
@@ -0,0 +1,49 @@
+#ifndef _RECT_PACKER_H
+#define _RECT_PACKER_H
+
+#include <vector>
+
+#include "Common.h"
+
+/*!
+ * Shelf rectangle packer. Rectangles are placed left to right on horizontal shelves, a new shelf
+ * is opened below the last one when no existing shelf fits. Good enough for sprites of similar
+ * heights, which is what the atlas gets.
+ */
+class RectPacker {
+public:
+    RectPacker(u32 width, u32 height);
+
+    /*!
+     * Finds room for a rectangle
+     * @param width width of the rectangle
+     * @param height height of the rectangle
+     * @param x receives the left edge on success
+     * @param y receives the top edge on success
+     * @return false if the rectangle doesn't fit anymore
+     */
+    bool pack(u32 width, u32 height, u32 &x, u32 &y);
+
+    /*!
+     * Forgets every packed rectangle
+     */
+    void clear();
+
+    u32 getWidth() const { return m_Width; }
+    u32 getHeight() const { return m_Height; }
+
+private:
+    struct Shelf {
+        u32 Y;
+        u32 Height;
+        u32 Used;
+    };
+
+    u32 m_Width;
+    u32 m_Height;
+    // Top of the free space below the last shelf
+    u32 m_Bottom = 0;
+    std::vector<Shelf> m_Shelves;
+};
+
+#endif //_RECT_PACKER_H
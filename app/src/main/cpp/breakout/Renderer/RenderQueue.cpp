@@ -0,0 +1,60 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+
+u64 RenderQueue::makeKey(bool translucent, u8 layer, u8 shader, GLuint texture, f32 depth) {
+    // Renderer depths are slices of [-1, 1], the rounding maps each slice to its own step
+    const f32 steps = static_cast<f32>(c_DepthMask + 1);
+    const u64 depthBits = static_cast<u64>(std::clamp((depth + 1.0f) * 0.5f * steps + 0.5f, 0.0f, steps - 1.0f));
+
+    if (translucent) {
+        return (1ull << 63) |
+               (static_cast<u64>(layer & 0x7Fu) << 56) |
+               (depthBits << 36) |
+               (static_cast<u64>(shader & 0xFu) << 32) |
+               texture;
+    }
+    return (static_cast<u64>(layer & 0x7Fu) << 56) |
+           (static_cast<u64>(shader & 0xFu) << 52) |
+           (static_cast<u64>(texture) << 20) |
+           depthBits;
+}
+
+void RenderQueue::submit(u64 key, const RenderCommand &command) {
+    m_Sorted.push_back(SortEntry{key, static_cast<u32>(m_Commands.size())});
+    m_Commands.push_back(command);
+}
+
+void RenderQueue::sort() {
+    const size_t count = m_Sorted.size();
+    m_Scratch.resize(count);
+
+    // LSD radix sort, one byte per pass. Passes where every key shares the byte are skipped
+    for (u32 shift = 0; shift < 64; shift += 8) {
+        size_t histogram[256] = {};
+        for (const auto &entry: m_Sorted) {
+            histogram[(entry.Key >> shift) & 0xFF]++;
+        }
+
+        if (histogram[(m_Sorted.empty() ? 0 : m_Sorted[0].Key >> shift) & 0xFF] == count) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (auto &bucket: histogram) {
+            const size_t bucketCount = bucket;
+            bucket = offset;
+            offset += bucketCount;
+        }
+
+        for (const auto &entry: m_Sorted) {
+            m_Scratch[histogram[(entry.Key >> shift) & 0xFF]++] = entry;
+        }
+        m_Sorted.swap(m_Scratch);
+    }
+}
+
+void RenderQueue::clear() {
+    m_Commands.clear();
+    m_Sorted.clear();
+}
@@ -0,0 +1,118 @@
+#ifndef _RENDER_QUEUE_H
+#define _RENDER_QUEUE_H
+
+#include <vector>
+#include <GLES3/gl3.h>
+
+#include "Common.h"
+#include "Math/MathTypes.h"
+#include "InstancedSprites.h"
+
+class Model;
+struct Vertex;
+
+/*!
+ * A single draw, recorded during the frame and executed on flush
+ */
+struct RenderCommand {
+    const Shader *Program = nullptr;
+    GLuint Texture = 0;
+    V3 Color = V3{1.0f};
+    // Area of the texture to sample, offset (xy) and size (zw)
+    V4 UVRect = V4{0.0f, 0.0f, 1.0f, 1.0f};
+    Mat4 Transform = Mat4{1.0f};
+    // Indexed model drawn with Transform, or null to draw Vertices
+    const Model *Mesh = nullptr;
+    // Triangle list, must stay valid until the queue is flushed (frame arena)
+    const Vertex *Vertices = nullptr;
+    u32 VertexCount = 0;
+    // Sprite drawn by the instanced backend, runs of these are batched into a single draw
+    bool Instanced = false;
+    // Needs blending, drawn after every opaque command
+    bool Translucent = false;
+    SpriteInstance Instance{};
+};
+
+/*!
+ * List of draw commands ordered by a 64 bit sort key.
+ *
+ * Opaque key layout, most significant bits first:
+ *  - 1 bit translucency: opaque commands are drawn first
+ *  - 7 bits layer: submission pass, earlier passes are drawn first
+ *  - 4 bits shader
+ *  - 32 bits texture: the whole GL name, different textures never share a batch key
+ *  - 20 bits depth
+ *
+ * Translucent commands are blended, so they are painted back to front whatever their state:
+ *  - 1 bit translucency
+ *  - 7 bits layer
+ *  - 20 bits depth
+ *  - 4 bits shader
+ *  - 32 bits texture
+ *
+ * Depth is quantized to 2^20 steps over [-1, 1], one per depth slice of the renderer.
+ *
+ * The sort is a stable radix sort, so commands with equal keys keep their submission order.
+ */
+class RenderQueue {
+public:
+    /*!
+     * Builds a sort key
+     * @param translucent whether the command is drawn in the blended pass
+     * @param layer submission pass, 7 bits
+     * @param shader index of the shader, 4 bits
+     * @param texture GL texture name
+     * @param depth depth of the draw in [-1, 1], lower values are drawn first
+     */
+    static u64 makeKey(bool translucent, u8 layer, u8 shader, GLuint texture, f32 depth);
+
+    /*!
+     * @return true if the key belongs to a translucent command
+     */
+    static bool isTranslucent(u64 key) { return key >> 63; }
+
+    /*!
+     * @return the key without its depth, consecutive commands sharing it can be drawn together
+     */
+    static u64 getBatchKey(u64 key) {
+        return key & (isTranslucent(key) ? ~(c_DepthMask << 36) : ~c_DepthMask);
+    }
+
+    void submit(u64 key, const RenderCommand &command);
+
+    /*!
+     * Sorts the submitted commands by key
+     */
+    void sort();
+
+    /*!
+     * Drops every command, the storage is kept for the next frame
+     */
+    void clear();
+
+    size_t size() const { return m_Commands.size(); }
+
+    /*!
+     * @param index position in sorted order, only valid after @a sort
+     */
+    const RenderCommand &operator[](size_t index) const { return m_Commands[m_Sorted[index].Index]; }
+
+    /*!
+     * @param index position in sorted order, only valid after @a sort
+     */
+    u64 getKey(size_t index) const { return m_Sorted[index].Key; }
+
+private:
+    static constexpr u64 c_DepthMask = (1ull << 20) - 1;
+
+    struct SortEntry {
+        u64 Key;
+        u32 Index;
+    };
+
+    std::vector<RenderCommand> m_Commands;
+    std::vector<SortEntry> m_Sorted;
+    std::vector<SortEntry> m_Scratch;
+};
+
+#endif //_RENDER_QUEUE_H
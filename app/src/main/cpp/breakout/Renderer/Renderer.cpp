@@ -2,6 +2,8 @@
 #include "Renderer.h"
 
 #include <game-activity/native_app_glue/android_native_app_glue.h>
+#include <algorithm>
+#include <chrono>
 #include <GLES3/gl3.h>
 #include <memory>
 #include <vector>
@@ -12,6 +14,8 @@
 #include "Utils/Utility.h"
 #include "Renderer/TextureAsset.h"
 #include "ECS/Components.h"
+#include "Memory/FrameArena.h"
+#include "Memory/MemoryTracker.h"
 
 //! executes glGetString and outputs the result to logcat
 #define PRINT_GL_STRING(s) {aout << #s": "<< glGetString(s) << std::endl;}
@@ -47,9 +51,10 @@ out vec2 fragUV;
 
 uniform mat4 uProjection;
 uniform mat4 uModel;
+uniform vec4 uUVRect;
 
 void main() {
-    fragUV = inUV;
+    fragUV = uUVRect.xy + inUV * uUVRect.zw;
     gl_Position = uProjection * uModel * vec4(inPosition, 1.0);
 }
 )vertex";
@@ -89,12 +94,25 @@ static constexpr float kProjectionNearPlane = -1.f;
  */
 static constexpr float kProjectionFarPlane = 1.f;
 
+/*!
+ * Shader indices used in the render queue sort keys
+ */
+static constexpr u8 kSpriteShader = 0;
+static constexpr u8 kTextShader = 1;
+
+/*!
+ * Draws with a distinct depth per frame. Each draw gets the next depth slice, so later submissions
+ * are in front of earlier ones just like painting them in order.
+ */
+static constexpr u32 kMaxDepthSlices = 1u << 20;
+
 void Renderer::initialize(android_app *app) {
     if(app == nullptr){
         aout << "Provided application is null!" << std::endl;
         return;
     }
     m_App = app;
+    MemoryScope memoryScope(MemoryTag::Renderer);
     // Choose your update attributes
     constexpr EGLint attribs[] = {
             EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT,
@@ -153,6 +171,7 @@ void Renderer::initialize(android_app *app) {
     // get some window metrics
     auto madeCurrent = eglMakeCurrent(display, surface, surface, context);
     assert(madeCurrent);
+    GLState::invalidate();
 
     m_Display = display;
     m_Surface = surface;
@@ -176,14 +195,18 @@ void Renderer::initialize(android_app *app) {
     // setup any other gl related global states
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
-    // enable alpha globally for now, you probably don't want to do this in a game
-    glEnable(GL_BLEND);
+    // Blending is only enabled for the translucent pass, see flush
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthFunc(GL_LESS);
 
     // get some demo models into memory
     createModels();
+    if (!m_InstancedSprites.initialize(*m_SpriteModel)) {
+        m_SpriteBackend = SpriteBackend::PerEntity;
+    }
     m_Fonts.initialize();
     m_Fonts.loadFont("Fonts/Arial.ttf");
+    m_GpuTimer.initialize();
 }
 
 Renderer::~Renderer() {
@@ -212,40 +235,66 @@ void Renderer::render(const Scene &scene, bool clear) {
         m_Fonts.m_Shader->activate();
         m_Fonts.m_Shader->setProjectionMatrix(projection);
 
+        if (m_InstancedSprites.getShader()) {
+            m_InstancedSprites.setProjectionMatrix(projection);
+        }
+
         // make sure the matrix isn't generated every frame
         m_ShaderNeedsNewProjectionMatrix = false;
     }
     if(clear){
-        glClear(GL_COLOR_BUFFER_BIT);
-        glClearColor(0.0f, 0.25f, 0.5f, 1.0f);
+        // The clear happens on flush, once the render target of the frame is bound
+        m_RenderQueue.clear();
+        m_Layer = 0;
+        m_DepthSlice = 0;
+        m_ClearPending = true;
     }
 
     {
-        m_Shaders->activate();
-        const auto &view = scene.getAllEntitiesWith<TransformComponent, SpriteComponent>();
-        for (const auto &entity: view) {
-            const auto &transform = view.get<TransformComponent>(entity);
-            const auto &sprite = view.get<SpriteComponent>(entity);
-
+        const auto &group = scene.getRenderables();
+        for (const auto &[entity, transform, sprite]: group.each()) {
             if(!transform.Enabled){
                 continue;
             }
 
-            if (m_Textures.size() <= sprite.Texture) {
+            const auto &texture = m_TextureRegistry.get(sprite.Texture);
+            if (!texture) {
                 aout << "Error: Texture is not valid!" << std::endl;
                 continue;
             }
-            const auto &texture = m_Textures[sprite.Texture];
-            const auto model = transform.getSpriteTransform();
 
-            m_Shaders->drawModel(model, *m_SpriteModel, *texture, sprite.Color);
+            const f32 depth = nextDepth();
+
+            RenderCommand command;
+            command.Program = m_Shaders.get();
+            command.Texture = texture->getTextureID();
+            command.Color = sprite.Color;
+            command.UVRect = texture->getUVRect();
+            command.Mesh = m_SpriteModel.get();
+            command.Translucent = !texture->isOpaque();
+            if (m_SpriteBackend == SpriteBackend::Instanced) {
+                command.Instanced = true;
+                command.Instance.Position = V3{transform.Translation.x, transform.Translation.y, depth};
+                command.Instance.Scale = V2{transform.Scale.x, transform.Scale.y};
+                command.Instance.Color = sprite.Color;
+                command.Instance.AtlasRect = command.UVRect;
+            } else {
+                command.Transform = transform.getSpriteTransform();
+                command.Transform[3][2] = depth;
+            }
+
+            // Opaque draws ignore layers, the depth test orders them, and go front to back so
+            // hidden pixels are rejected before shading. Translucent ones are painted in order
+            m_RenderQueue.submit(
+                    command.Translucent
+                    ? RenderQueue::makeKey(true, m_Layer, kSpriteShader, command.Texture, depth)
+                    : RenderQueue::makeKey(false, 0, kSpriteShader, command.Texture, -depth),
+                    command);
         }
-        m_Shaders->deactivate();
     }
 
 
     {
-        m_Fonts.m_Shader->activate();
         const auto& view = scene.getAllEntitiesWith<TransformComponent, TextComponent>();
         for(const auto& entity : view){
             const auto &transform = view.get<TransformComponent>(entity);
@@ -255,44 +304,301 @@ void Renderer::render(const Scene &scene, bool clear) {
                 continue;
             }
 
-            f32 x = transform.Translation.x;
-            for(const auto c : text.Text){
-                Character ch = m_Fonts.m_Characters[c];
-
-                const f32 xPos = x + ch.Bearing.x * transform.Scale.x;
-                const f32 yPos = transform.Translation.y + (m_Fonts.m_Characters['H'].Bearing.y - ch.Bearing.y) * transform.Scale.y;
+            updateTextLayout(text);
+            const auto &glyphs = text.Layout->Glyphs;
+            if (glyphs.empty()) {
+                continue;
+            }
 
-                const f32 w = ch.Size.x * transform.Scale.x;
-                const f32 h = ch.Size.y * transform.Scale.y;
+            const f32 depth = nextDepth();
 
-                std::vector<Vertex> vertices = {
-                        Vertex(Vector3{xPos, yPos + h, 0}, Vector2{0, 1}), // 0
-                        Vertex(Vector3{xPos, yPos, 0}, Vector2{0, 0}), // 1
-                        Vertex(Vector3{xPos + w, yPos, 0}, Vector2{1, 0}), // 2
+            // Glyph quads are drawn on flush, build them in the frame arena
+            Vertex *vertices = FrameArena::allocate<Vertex>(glyphs.size() * 6);
+            Vertex *vertex = vertices;
+            for (const auto &glyph: glyphs) {
+                const f32 xPos = transform.Translation.x + glyph.Position.x * transform.Scale.x;
+                const f32 yPos = transform.Translation.y + glyph.Position.y * transform.Scale.y;
 
-                        Vertex(Vector3{xPos, yPos + h, 0}, Vector2{0, 1}), // 3
-                        Vertex(Vector3{xPos + w, yPos, 0}, Vector2{1, 0}), // 4
-                        Vertex(Vector3{xPos + w, yPos + h, 0}, Vector2{1, 1}) // 5
-                };
+                const f32 w = glyph.Size.x * transform.Scale.x;
+                const f32 h = glyph.Size.y * transform.Scale.y;
 
-                Model model = Model(vertices,  {});
+                const f32 u0 = glyph.UVRect.x;
+                const f32 v0 = glyph.UVRect.y;
+                const f32 u1 = glyph.UVRect.x + glyph.UVRect.z;
+                const f32 v1 = glyph.UVRect.y + glyph.UVRect.w;
 
+                new(vertex++) Vertex(Vector3{xPos, yPos + h, depth}, Vector2{u0, v1}); // 0
+                new(vertex++) Vertex(Vector3{xPos, yPos, depth}, Vector2{u0, v0}); // 1
+                new(vertex++) Vertex(Vector3{xPos + w, yPos, depth}, Vector2{u1, v0}); // 2
 
-                m_Fonts.m_Shader->drawModel(model, ch.TextureID, text.Color);
+                new(vertex++) Vertex(Vector3{xPos, yPos + h, depth}, Vector2{u0, v1}); // 3
+                new(vertex++) Vertex(Vector3{xPos + w, yPos, depth}, Vector2{u1, v0}); // 4
+                new(vertex++) Vertex(Vector3{xPos + w, yPos + h, depth}, Vector2{u1, v1}); // 5
+            }
 
-                x += (ch.Advance >> 6) * transform.Scale.x;
+            // Consecutive glyphs of the same atlas page are drawn together
+            size_t first = 0;
+            while (first < glyphs.size()) {
+                const u32 page = glyphs[first].Page;
+                size_t last = first + 1;
+                while (last < glyphs.size() && glyphs[last].Page == page) {
+                    last++;
+                }
+                m_Fonts.markUsed(page);
+
+                RenderCommand command;
+                command.Program = m_Fonts.m_Shader.get();
+                command.Texture = m_Fonts.getPageTexture(page);
+                command.Color = text.Color;
+                command.Vertices = vertices + first * 6;
+                command.VertexCount = (last - first) * 6;
+                command.Translucent = true;
+
+                m_RenderQueue.submit(
+                        RenderQueue::makeKey(true, m_Layer, kTextShader, command.Texture, depth),
+                        command);
+                first = last;
             }
         }
+    }
 
-        m_Fonts.m_Shader->deactivate();
+    m_Layer++;
+}
+
+f32 Renderer::nextDepth() {
+    if (m_DepthSlice == kMaxDepthSlices - 1) {
+        aout << "Error: Out of depth slices, draws will overlap" << std::endl;
+    } else {
+        m_DepthSlice++;
     }
+    // The orthographic projection maps z from -1 (back) to 1 (front)
+    return -1.0f + 2.0f * static_cast<f32>(m_DepthSlice) / kMaxDepthSlices;
+}
 
+void Renderer::updateTextLayout(const TextComponent &text) {
+    if (text.Dirty || !text.Layout || text.Layout->Generation != m_Fonts.getGeneration()) {
+        text.Layout = m_TextLayout.layout(text.Text, text.Style);
+        text.Dirty = false;
+    }
+}
 
+V2 Renderer::measureText(const TextComponent &text) {
+    updateTextLayout(text);
+    return text.Layout->Bounds;
 }
+
 void Renderer::flush() {
+    m_GpuTimer.begin();
+    m_SpriteAtlas.update();
+
+    bindRenderTarget();
+    if (m_ClearPending) {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glClearColor(0.0f, 0.25f, 0.5f, 1.0f);
+        m_ClearPending = false;
+    }
+
+    m_RenderQueue.sort();
+
+    // Stream every triangle list of the frame with a single map, drawn in the same order below
+    size_t streamedVertices = 0;
+    for (size_t i = 0; i < m_RenderQueue.size(); i++) {
+        if (!m_RenderQueue[i].Mesh && !m_RenderQueue[i].Instanced) {
+            streamedVertices += m_RenderQueue[i].VertexCount;
+        }
+    }
+    GLintptr streamOffset = -1;
+    if (streamedVertices > 0) {
+        auto *destination = static_cast<Vertex *>(
+                m_VertexStream.map(streamedVertices * sizeof(Vertex), sizeof(Vertex), streamOffset));
+        if (destination) {
+            for (size_t i = 0; i < m_RenderQueue.size(); i++) {
+                const RenderCommand &command = m_RenderQueue[i];
+                if (!command.Mesh && !command.Instanced) {
+                    std::copy_n(command.Vertices, command.VertexCount, destination);
+                    destination += command.VertexCount;
+                }
+            }
+            m_VertexStream.unmap();
+        } else {
+            streamOffset = -1;
+        }
+    }
+
+    // Opaque pass: depth tested and written, no blending
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+    bool translucentPass = false;
+
+    for (size_t i = 0; i < m_RenderQueue.size(); i++) {
+        const RenderCommand &command = m_RenderQueue[i];
+
+        if (command.Translucent && !translucentPass) {
+            // Translucent pass: still hidden behind opaque draws, but blended and not occluding
+            glEnable(GL_BLEND);
+            glDepthMask(GL_FALSE);
+            translucentPass = true;
+        }
+
+        if (command.Instanced) {
+            // Sorted keys put opaque sprites sharing layer, shader and texture next to each other,
+            // translucent ones only batch while consecutive in depth order
+            const u64 batchKey = RenderQueue::getBatchKey(m_RenderQueue.getKey(i));
+            size_t end = i + 1;
+            while (end < m_RenderQueue.size()
+                   && m_RenderQueue[end].Instanced
+                   && m_RenderQueue[end].Translucent == command.Translucent
+                   && m_RenderQueue[end].Texture == command.Texture
+                   && RenderQueue::getBatchKey(m_RenderQueue.getKey(end)) == batchKey) {
+                end++;
+            }
+
+            const u32 count = end - i;
+            SpriteInstance *instances = FrameArena::allocate<SpriteInstance>(count);
+            for (u32 j = 0; j < count; j++) {
+                instances[j] = m_RenderQueue[i + j].Instance;
+            }
+            m_InstancedSprites.draw(instances, count, command.Texture);
+
+            i = end - 1;
+            continue;
+        }
+
+        command.Program->activate();
+
+        if (command.Mesh) {
+            command.Program->drawModel(command.Transform, *command.Mesh, command.Texture, command.Color, command.UVRect);
+        } else if (streamOffset >= 0) {
+            command.Program->drawVertices(m_VertexStream.getBuffer(), streamOffset, command.VertexCount,
+                                          command.Texture, command.Color);
+            streamOffset += command.VertexCount * sizeof(Vertex);
+        } else {
+            command.Program->drawVertices(command.Vertices, command.VertexCount, command.Texture, command.Color);
+        }
+    }
+    // glClear only clears depth while writes are enabled
+    glDepthMask(GL_TRUE);
+
+    m_RenderQueue.clear();
+    m_Layer = 0;
+    m_DepthSlice = 0;
+    m_VertexStream.endFrame();
+    m_InstancedSprites.endFrame();
+    m_Fonts.endFrame();
+    GLState::endFrame();
+
+    resolveRenderTarget();
+    m_GpuTimer.end();
+
+    // The swap waits for vsync, timing up to it shows how much of the frame was actually used.
+    // The GPU runs behind the CPU, its own time arrives a few frames late when it can be measured
+    const auto workEnd = std::chrono::steady_clock::now();
+    if (m_FrameStart != std::chrono::steady_clock::time_point{}) {
+        f32 frameMs = std::chrono::duration<f32, std::milli>(workEnd - m_FrameStart).count();
+        m_GpuTimer.poll(m_GpuMs);
+        frameMs = std::max(frameMs, m_GpuMs);
+        if (m_DynamicResolution.update(frameMs)) {
+            aout << "Render scale " << m_DynamicResolution.getScale() << " at "
+                 << m_DynamicResolution.getAverageMs() << "ms" << std::endl;
+        }
+    }
+
     // Present the rendered image. This is an implicit glFlush.
     auto swapResult = eglSwapBuffers(m_Display, m_Surface);
     assert(swapResult == EGL_TRUE);
+    m_FrameStart = std::chrono::steady_clock::now();
+}
+
+void Renderer::setSpriteBackend(SpriteBackend backend) {
+    if (backend == SpriteBackend::Instanced && !m_InstancedSprites.getShader()) {
+        aout << "Instanced sprites are unavailable, drawing them one by one" << std::endl;
+        backend = SpriteBackend::PerEntity;
+    }
+    m_SpriteBackend = backend;
+}
+
+void Renderer::setDynamicResolution(bool enabled) {
+    m_DynamicResolution.setEnabled(enabled);
+    if (!enabled) {
+        destroyRenderTarget();
+    }
+}
+
+void Renderer::bindRenderTarget() {
+    const f32 scale = m_DynamicResolution.getScale();
+
+    // Allocated at window size once, lower scales render into a corner of it
+    if (scale < 1.0f && !m_Framebuffer) {
+        createRenderTarget();
+    }
+
+    // A target that failed to allocate turns dynamic resolution off, draw at full size
+    if (scale >= 1.0f || !m_Framebuffer) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, m_Width, m_Height);
+        return;
+    }
+
+    m_RenderWidth = std::max(1, static_cast<EGLint>(m_Width * scale));
+    m_RenderHeight = std::max(1, static_cast<EGLint>(m_Height * scale));
+    glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+    glViewport(0, 0, m_RenderWidth, m_RenderHeight);
+}
+
+void Renderer::resolveRenderTarget() {
+    if (m_DynamicResolution.getScale() >= 1.0f || !m_Framebuffer) {
+        return;
+    }
+
+    // Upscale to the window
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_Framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, m_RenderWidth, m_RenderHeight, 0, 0, m_Width, m_Height,
+                      GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+    // Nothing reads the offscreen buffers again, tiled GPUs can skip writing them back
+    constexpr GLenum attachments[] = {GL_COLOR_ATTACHMENT0, GL_DEPTH_ATTACHMENT};
+    glInvalidateFramebuffer(GL_READ_FRAMEBUFFER, 2, attachments);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Renderer::createRenderTarget() {
+    glGenFramebuffers(1, &m_Framebuffer);
+    glGenRenderbuffers(1, &m_ColorBuffer);
+    glGenRenderbuffers(1, &m_DepthBuffer);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, m_ColorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_Width, m_Height);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_DepthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_Width, m_Height);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_DepthBuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        aout << "Error: Render target is incomplete, dynamic resolution disabled" << std::endl;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        setDynamicResolution(false);
+        return;
+    }
+
+    m_TargetBytes = static_cast<u64>(m_Width) * m_Height * 8;
+    MemoryTracker::recordGpuAllocation(MemoryTag::Renderer, m_TargetBytes);
+}
+
+void Renderer::destroyRenderTarget() {
+    if (!m_Framebuffer) {
+        return;
+    }
+    glDeleteFramebuffers(1, &m_Framebuffer);
+    glDeleteRenderbuffers(1, &m_ColorBuffer);
+    glDeleteRenderbuffers(1, &m_DepthBuffer);
+    m_Framebuffer = 0;
+    m_ColorBuffer = 0;
+    m_DepthBuffer = 0;
+    MemoryTracker::recordGpuFree(MemoryTag::Renderer, m_TargetBytes);
+    m_TargetBytes = 0;
 }
 
 void Renderer::updateRenderArea() {
@@ -307,6 +613,9 @@ void Renderer::updateRenderArea() {
         m_Height = height;
         glViewport(0, 0, width, height);
 
+        // Recreated at the new size the next time a scaled frame needs it
+        destroyRenderTarget();
+
         // make sure that we lazily recreate the projection matrix before we update
         m_ShaderNeedsNewProjectionMatrix = true;
     }
@@ -335,17 +644,28 @@ void Renderer::createModels() {
     // Create a model and put it in the back of the update list.
     m_SpriteModel = std::make_unique<Model>(vertices, indices);
 }
-u32 Renderer::loadTexture(const std::string &path) {
-    // loads an image and assigns it to the square.
-    //
-    // Note: there is no texture management in this sample, so if you reuse an image be careful not
-    // to load it repeatedly. Since you get a shared_ptr you can safely reuse it in many models.
-    m_Textures.emplace_back(TextureAsset::loadAsset(m_App->activity->assetManager, path));
-    return m_Textures.size() - 1;
+TextureHandle Renderer::loadTexture(const std::string &path) {
+    MemoryScope memoryScope(MemoryTag::Textures);
+    return m_TextureRegistry.load(path);
+}
+
+std::shared_ptr<TextureAsset> Renderer::createTexture(const std::string &path) {
+    u32 width = 0;
+    u32 height = 0;
+    const auto pixels = TextureAsset::decodeAsset(m_App->activity->assetManager, path, width, height);
+
+    // Sprites share atlas pages so they can be batched, images too big for a page get their own texture
+    auto texture = m_SpriteAtlas.add(pixels.data(), width, height);
+    if (!texture) {
+        texture = TextureAsset::create(width, height, pixels.data());
+    }
+    return texture;
 }
 
 void Renderer::shutdown() {
     if (m_Display != EGL_NO_DISPLAY) {
+        destroyRenderTarget();
+        m_GpuTimer.destroy();
         eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
         if (m_Context != EGL_NO_CONTEXT) {
             eglDestroyContext(m_Display, m_Context);
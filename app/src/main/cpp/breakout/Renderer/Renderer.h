@@ -6,12 +6,31 @@
 struct android_app;
 
 #include <EGL/egl.h>
+#include <chrono>
 #include <memory>
 
 #include "Renderer/Model.h"
 #include "Renderer/Shader.h"
 #include "ECS/Scene.h"
 #include "Fonts.h"
+#include "RenderQueue.h"
+#include "InstancedSprites.h"
+#include "StreamBuffer.h"
+#include "TextureAtlas.h"
+#include "TextureRegistry.h"
+#include "TextLayout.h"
+#include "DynamicResolution.h"
+#include "GpuTimer.h"
+
+/*!
+ * How sprites are submitted to the GPU
+ */
+enum class SpriteBackend {
+    // One draw per sprite through Shader::drawModel
+    PerEntity,
+    // One instanced draw per run of sprites sharing a texture
+    Instanced
+};
 
 
 class Renderer {
@@ -22,20 +41,61 @@ public:
             m_Context(EGL_NO_CONTEXT),
             m_Width(0),
             m_Height(0),
-            m_ShaderNeedsNewProjectionMatrix(true) {}
+            m_ShaderNeedsNewProjectionMatrix(true),
+            m_TextureRegistry([this](const std::string &path) { return createTexture(path); }) {}
 
     ~Renderer();
 
     void initialize(android_app *app);
 
+    /*!
+     * Records the draws of a scene. Every call is a new layer drawn on top of the previous ones
+     * @param scene scene to draw
+     * @param clear drops whatever was recorded before and clears the screen
+     */
     void render(const Scene &scene, bool clear = true);
 
+    /*!
+     * Sorts and executes the recorded draws, then presents the frame
+     */
     void flush();
 
     void shutdown();
 
-    u32 loadTexture(const std::string& path);
-    std::shared_ptr<TextureAsset> getTexture(u32 id) const { return m_Textures[id]; }
+    /*!
+     * Loads an image, or returns the texture already loaded for the path
+     * @param path asset path of the image
+     * @return handle keeping the texture loaded, its id goes in SpriteComponent::Texture
+     */
+    TextureHandle loadTexture(const std::string& path);
+    const std::shared_ptr<TextureAsset> &getTexture(u32 id) const { return m_TextureRegistry.get(id); }
+
+    /*!
+     * Turns the frame time driven render scale on or off. Off renders at the window resolution
+     */
+    void setDynamicResolution(bool enabled);
+
+    /*!
+     * @return the fraction of the window resolution frames are rendered at
+     */
+    f32 getRenderScale() const { return m_DynamicResolution.getScale(); }
+
+    /*!
+     * @return the extent of a text, unscaled, from the origin of its transform
+     */
+    V2 measureText(const TextComponent &text);
+
+    /*!
+     * Sets how much GPU memory textures without handles may keep cached
+     */
+    void setTextureBudget(u64 bytes) { m_TextureRegistry.setBudget(bytes); }
+
+    /*!
+     * Selects the sprite backend, takes effect on the next recorded frame. Falls back to
+     * PerEntity when the instanced shader couldn't be created
+     */
+    void setSpriteBackend(SpriteBackend backend);
+    SpriteBackend getSpriteBackend() const { return m_SpriteBackend; }
 
     u32 width() const { return m_Width;}
     u32 height() const { return m_Height; }
@@ -52,6 +112,36 @@ private:
      */
     void createModels();
 
+    /*!
+     * Binds the framebuffer and viewport of the frame: the window at full scale, otherwise the
+     * offscreen target
+     */
+    void bindRenderTarget();
+
+    /*!
+     * Upscales the offscreen target to the window, if the frame used it
+     */
+    void resolveRenderTarget();
+
+    void createRenderTarget();
+
+    void destroyRenderTarget();
+
+    /*!
+     * @return the depth of the next draw, in front of every draw recorded before in the frame
+     */
+    f32 nextDepth();
+
+    /*!
+     * Fetches the glyph layout of a text if its cached one is missing or stale
+     */
+    void updateTextLayout(const TextComponent &text);
+
+    /*!
+     * Decodes an image into the sprite atlas, @a TextureRegistry loader
+     */
+    std::shared_ptr<TextureAsset> createTexture(const std::string &path);
+
 
     EGLDisplay m_Display;
     EGLSurface m_Surface;
@@ -63,10 +153,37 @@ private:
 
     std::unique_ptr <Shader> m_Shaders;
 
-    std::vector<std::shared_ptr<TextureAsset>> m_Textures;
+    TextureAtlas m_SpriteAtlas;
+    // Indexed by SpriteComponent::Texture, mostly regions of m_SpriteAtlas
+    TextureRegistry m_TextureRegistry;
     std::unique_ptr<Model> m_SpriteModel;
 
+    InstancedSprites m_InstancedSprites;
+    SpriteBackend m_SpriteBackend = SpriteBackend::PerEntity;
+
+    RenderQueue m_RenderQueue;
+    // Triangle lists recorded during the frame (text) are streamed through here on flush
+    StreamBuffer m_VertexStream{GL_ARRAY_BUFFER, 64 * 1024};
+    u8 m_Layer = 0;
+    u32 m_DepthSlice = 0;
+    bool m_ClearPending = false;
+
+    DynamicResolution m_DynamicResolution;
+    // End of the last present, frames are timed from here to just before the next swap
+    std::chrono::steady_clock::time_point m_FrameStart;
+    GpuTimer m_GpuTimer;
+    // Newest GPU time of a frame, 0 until the timer reports one
+    f32 m_GpuMs = 0.0f;
+    // Offscreen target used below full scale
+    GLuint m_Framebuffer = 0;
+    GLuint m_ColorBuffer = 0;
+    GLuint m_DepthBuffer = 0;
+    EGLint m_RenderWidth = 0;
+    EGLint m_RenderHeight = 0;
+    u64 m_TargetBytes = 0;
+
     Fonts m_Fonts;
+    TextLayout m_TextLayout{m_Fonts};
 
     android_app* m_App;
 };
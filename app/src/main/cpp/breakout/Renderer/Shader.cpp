@@ -64,6 +64,9 @@ Shader *Shader::loadShader(
                     program,
                     colorUniformName.c_str());
 
+            // Optional, only sprite programs sample part of a texture
+            GLint uvRectUniform = glGetUniformLocation(program, "uUVRect");
+
             // Only create a new shader if all the attributes are found.
             if (positionAttribute != -1
                 && uvAttribute != -1
@@ -75,7 +78,8 @@ Shader *Shader::loadShader(
                         uvAttribute,
                         projectionMatrixUniform,
                         modelMatrixUniform,
-                        colorUniform);
+                        colorUniform,
+                        uvRectUniform);
             } else {
                 glDeleteProgram(program);
             }
@@ -121,49 +125,32 @@ GLuint Shader::loadShader(GLenum shaderType, const std::string &shaderSource) {
 }
 
 void Shader::activate() const {
-    glUseProgram(m_ShaderID);
+    GLState::useProgram(m_ShaderID);
 }
 
 void Shader::deactivate() const {
-    glUseProgram(0);
+    GLState::useProgram(0);
 }
 
 void Shader::drawModel(const Mat4& transform, const Model &model, const TextureAsset& texture, const V3& color) const {
-    // The position attribute is 3 floats
-    glVertexAttribPointer(
-            m_Position, // attrib
-            3, // elements
-            GL_FLOAT, // of type float
-            GL_FALSE, // don't normalize
-            sizeof(Vertex), // stride is Vertex bytes
-            model.getVertexData() // pull from the start of the vertex data
-    );
-    glEnableVertexAttribArray(m_Position);
+    drawModel(transform, model, texture.getTextureID(), color, texture.getUVRect());
+}
 
-    // The uv attribute is 2 floats
-    glVertexAttribPointer(
-            m_TexCoords, // attrib
-            2, // elements
-            GL_FLOAT, // of type float
-            GL_FALSE, // don't normalize
-            sizeof(Vertex), // stride is Vertex bytes
-            ((uint8_t *) model.getVertexData()) + sizeof(Vector3) // offset Vector3 from the start
-    );
-    glEnableVertexAttribArray(m_TexCoords);
+void Shader::drawModel(const Mat4& transform, const Model &model, GLuint texture, const V3& color,
+                       const V4& uvRect) const {
+    // Client side array, nothing may be bound
+    GLState::bindArrayBuffer(0);
+    setVertexAttributes(model.getVertexData());
 
     glUniformMatrix4fv(m_ModelMatrix, 1, false, glm::value_ptr(transform));
     glUniform3f(m_Color, color.x, color.y, color.z);
-
+    glUniform4f(m_UVRect, uvRect.x, uvRect.y, uvRect.z, uvRect.w);
 
     // Setup the texture
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texture.getTextureID());
+    GLState::bindTexture(texture);
 
     // Draw as indexed triangles
     glDrawElements(GL_TRIANGLES, model.getIndexCount(), GL_UNSIGNED_SHORT, model.getIndexData());
-
-    glDisableVertexAttribArray(m_TexCoords);
-    glDisableVertexAttribArray(m_Position);
 }
 
 void Shader::setProjectionMatrix(const Mat4& projectionMatrix) const {
@@ -171,6 +158,36 @@ void Shader::setProjectionMatrix(const Mat4& projectionMatrix) const {
 }
 
 void Shader::drawModel(const Model &model, u32 texture, const V3 &color) const {
+    drawVertices(model.getVertexData(), model.getVertexCount(), texture, color);
+}
+
+void Shader::drawVertices(const Vertex *vertices, size_t count, u32 texture, const V3 &color) const {
+    // Client side array, nothing may be bound
+    GLState::bindArrayBuffer(0);
+    setVertexAttributes(vertices);
+
+    glUniform3f(m_Color, color.x, color.y, color.z);
+
+    // Setup the texture
+    GLState::bindTexture(texture);
+
+    glDrawArrays(GL_TRIANGLES, 0, count);
+}
+
+void Shader::drawVertices(GLuint buffer, GLintptr offset, size_t count, u32 texture, const V3 &color) const {
+    // With a buffer bound the attribute pointers are offsets into it
+    GLState::bindArrayBuffer(buffer);
+    setVertexAttributes(reinterpret_cast<const void *>(offset));
+
+    glUniform3f(m_Color, color.x, color.y, color.z);
+
+    // Setup the texture
+    GLState::bindTexture(texture);
+
+    glDrawArrays(GL_TRIANGLES, 0, count);
+}
+
+void Shader::setVertexAttributes(const void *vertices) const {
     // The position attribute is 3 floats
     glVertexAttribPointer(
             m_Position, // attrib
@@ -178,9 +195,9 @@ void Shader::drawModel(const Model &model, u32 texture, const V3 &color) const {
             GL_FLOAT, // of type float
             GL_FALSE, // don't normalize
             sizeof(Vertex), // stride is Vertex bytes
-            model.getVertexData() // pull from the start of the vertex data
+            vertices // pull from the start of the vertex data
     );
-    glEnableVertexAttribArray(m_Position);
+    GLState::enableVertexAttribArray(m_Position);
 
     // The uv attribute is 2 floats
     glVertexAttribPointer(
@@ -189,20 +206,7 @@ void Shader::drawModel(const Model &model, u32 texture, const V3 &color) const {
             GL_FLOAT, // of type float
             GL_FALSE, // don't normalize
             sizeof(Vertex), // stride is Vertex bytes
-            ((uint8_t *) model.getVertexData()) + sizeof(Vector3) // offset Vector3 from the start
+            ((const uint8_t *) vertices) + sizeof(Vector3) // offset Vector3 from the start
     );
-    glEnableVertexAttribArray(m_TexCoords);
-
-    glUniform3f(m_Color, color.x, color.y, color.z);
-
-
-    // Setup the texture
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texture);
-
-    // Draw as indexed triangles
-    glDrawArrays(GL_TRIANGLES, 0, model.getVertexCount());
-
-    glDisableVertexAttribArray(m_TexCoords);
-    glDisableVertexAttribArray(m_Position);
+    GLState::enableVertexAttribArray(m_TexCoords);
 }
@@ -5,8 +5,10 @@
 #include <GLES3/gl3.h>
 #include "TextureAsset.h"
 #include "Math/MathTypes.h"
+#include "GLState.h"
 
 class Model;
+struct Vertex;
 
 /*!
  * A class representing a simple shader program. It consists of vertex and fragment components. The
@@ -40,7 +42,7 @@ public:
 
     inline ~Shader() {
         if (m_ShaderID) {
-            glDeleteProgram(m_ShaderID);
+            GLState::deleteProgram(m_ShaderID);
             m_ShaderID = 0;
         }
     }
@@ -51,7 +53,7 @@ public:
     void activate() const;
 
     /*!
-     * Cleans up the shader after use, call this after executing any draw commands
+     * Unbinds the shader. Not needed between draws, binds are filtered by GLState
      */
     void deactivate() const;
 
@@ -64,6 +66,18 @@ public:
      */
     void drawModel(const Mat4& transform, const Model &model, const TextureAsset& texture, const V3& color) const;
 
+    /*!
+     * Renders a single model
+     * @param transform model transform
+     * @param model a model to draw
+     * @param texture GL name of the texture to draw
+     * @param color color of the model
+     * @param uvRect area of the texture to map on the model, offset (xy) and size (zw). Needs a
+     * uUVRect uniform in the vertex program, ignored otherwise
+     */
+    void drawModel(const Mat4& transform, const Model &model, GLuint texture, const V3& color,
+                   const V4& uvRect = V4{0.0f, 0.0f, 1.0f, 1.0f}) const;
+
     /*!
      * Renders a single model
      * @param model a model to draw
@@ -71,6 +85,26 @@ public:
      * @param color color of the model
      */
     void drawModel(const Model& model, u32 texture, const V3& color) const;
+
+    /*!
+     * Renders a non indexed triangle list
+     * @param vertices vertex data, only read during the call
+     * @param count amount of vertices to draw
+     * @param texture a texture to draw
+     * @param color color of the triangles
+     */
+    void drawVertices(const Vertex *vertices, size_t count, u32 texture, const V3& color) const;
+
+    /*!
+     * Renders a non indexed triangle list stored in a vertex buffer
+     * @param buffer GL buffer holding the vertices
+     * @param offset byte offset of the first vertex in the buffer
+     * @param count amount of vertices to draw
+     * @param texture a texture to draw
+     * @param color color of the triangles
+     */
+    void drawVertices(GLuint buffer, GLintptr offset, size_t count, u32 texture, const V3& color) const;
+
     /*!
      * Sets the model/view/projection matrix in the shader.
      * @param projectionMatrix sixteen floats, column major, defining an OpenGL projection matrix.
@@ -78,6 +112,12 @@ public:
     void setProjectionMatrix(const Mat4& projectionMatrix) const;
 
 private:
+    /*!
+     * Points the position and uv attributes at interleaved @a Vertex data
+     * @param vertices client memory, or an offset when a buffer is bound
+     */
+    void setVertexAttributes(const void *vertices) const;
+
     /*!
      * Helper function to load a shader of a given type
      * @param shaderType The OpenGL shader type. Should either be GL_VERTEX_SHADER or GL_FRAGMENT_SHADER
@@ -99,13 +139,15 @@ private:
             GLint uv,
             GLint projectionMatrix,
             GLint modelMatrix,
-            GLint color)
+            GLint color,
+            GLint uvRect)
             : m_ShaderID(program),
               m_Position(position),
               m_TexCoords(uv),
               m_ProjectionMatrix(projectionMatrix),
               m_ModelMatrix(modelMatrix),
-              m_Color(color){}
+              m_Color(color),
+              m_UVRect(uvRect){}
 
     GLuint m_ShaderID;
     GLint m_Position;
@@ -113,6 +155,7 @@ private:
     GLint m_ProjectionMatrix;
     GLint m_ModelMatrix;
     GLint m_Color;
+    GLint m_UVRect;
 };
 
 #endif //ANDROIDGLINVESTIGATIONS_SHADER_H
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "StreamBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Core/AndroidOut.h"
+#include "GLState.h"
+#include "Memory/MemoryTracker.h"
+
+StreamBuffer::StreamBuffer(GLenum target, u32 segmentSize) : m_Target(target), m_SegmentSize(segmentSize) {}
+
+StreamBuffer::~StreamBuffer() {
+    for (auto &fence: m_Fences) {
+        if (fence) {
+            glDeleteSync(fence);
+        }
+    }
+    if (m_Buffer) {
+        MemoryTracker::recordGpuFree(MemoryTag::Renderer, m_Capacity);
+        GLState::deleteBuffer(m_Buffer);
+    }
+}
+
+void *StreamBuffer::map(u32 size, u32 alignment, GLintptr &offset) {
+    if (!m_Buffer) {
+        glGenBuffers(1, &m_Buffer);
+        grow(m_SegmentSize);
+    }
+
+    u32 start = (m_Head + alignment - 1) / alignment * alignment;
+    if (start + size > m_SegmentSize) {
+        grow(std::max(m_SegmentSize * 2, size + alignment));
+        start = 0;
+    }
+
+    // First write of the frame, the GPU may still read the segment from kFramesInFlight frames ago
+    GLsync &fence = m_Fences[m_Segment];
+    if (!m_Waited && fence) {
+        GLenum result = glClientWaitSync(fence, 0, 0);
+        if (result == GL_TIMEOUT_EXPIRED) {
+            m_Stalls++;
+            do {
+                result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+            } while (result == GL_TIMEOUT_EXPIRED);
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+    m_Waited = true;
+
+    offset = static_cast<GLintptr>(m_Segment) * m_SegmentSize + start;
+    m_Head = start + size;
+
+    bind();
+    return glMapBufferRange(m_Target, offset, size,
+                            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+}
+
+void StreamBuffer::unmap() {
+    bind();
+    glUnmapBuffer(m_Target);
+}
+
+GLintptr StreamBuffer::write(const void *data, u32 size, u32 alignment) {
+    GLintptr offset = 0;
+    void *destination = map(size, alignment, offset);
+    if (!destination) {
+        aout << "Error: Couldn't map the stream buffer" << std::endl;
+        return -1;
+    }
+    std::memcpy(destination, data, size);
+    unmap();
+    return offset;
+}
+
+void StreamBuffer::endFrame() {
+    if (m_Head == 0) {
+        return;
+    }
+    m_Fences[m_Segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_Segment = (m_Segment + 1) % kFramesInFlight;
+    m_Head = 0;
+    m_Waited = false;
+}
+
+void StreamBuffer::bind() const {
+    if (m_Target == GL_ARRAY_BUFFER) {
+        GLState::bindArrayBuffer(m_Buffer);
+    } else {
+        glBindBuffer(m_Target, m_Buffer);
+    }
+}
+
+void StreamBuffer::grow(u32 segmentSize) {
+    if (m_Capacity) {
+        aout << "Stream buffer segment grown to " << segmentSize << " bytes" << std::endl;
+        MemoryTracker::recordGpuFree(MemoryTag::Renderer, m_Capacity);
+    }
+
+    // New storage, draws already issued keep reading the old one
+    m_SegmentSize = segmentSize;
+    m_Capacity = static_cast<u64>(m_SegmentSize) * kFramesInFlight;
+    bind();
+    glBufferData(m_Target, static_cast<GLsizeiptr>(m_Capacity), nullptr, GL_STREAM_DRAW);
+    MemoryTracker::recordGpuAllocation(MemoryTag::Renderer, m_Capacity);
+
+    for (auto &fence: m_Fences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    m_Head = 0;
+}
@@ -0,0 +1,78 @@
+#ifndef _STREAM_BUFFER_H
+#define _STREAM_BUFFER_H
+
+#include <array>
+#include <GLES3/gl3.h>
+
+#include "Common.h"
+
+/*!
+ * Ring buffer for geometry written by the CPU every frame. The buffer holds one segment per frame
+ * in flight, a frame only writes to its own segment and a fence tells when the GPU is done with it,
+ * so writes map the range unsynchronized and never wait on the driver.
+ *
+ * The data of a write must be drawn before the next write, a segment that runs out of space grows
+ * the buffer which drops what was written but not drawn yet.
+ */
+class StreamBuffer {
+public:
+    //! Frames the CPU may run ahead of the GPU
+    static constexpr u32 kFramesInFlight = 3;
+
+    /*!
+     * @param target buffer binding point, GL_ARRAY_BUFFER for vertices
+     * @param segmentSize bytes available to each frame, grows on demand
+     */
+    StreamBuffer(GLenum target, u32 segmentSize);
+
+    ~StreamBuffer();
+
+    DISABLE_MOVE_AND_COPY(StreamBuffer)
+
+    /*!
+     * Maps space in the segment of the current frame and binds the buffer
+     * @param size bytes to write
+     * @param alignment alignment of the offset
+     * @param offset receives the offset of the space in the buffer
+     * @return the mapped space, write it then call @a unmap. Null if mapping failed
+     */
+    void *map(u32 size, u32 alignment, GLintptr &offset);
+
+    void unmap();
+
+    /*!
+     * Copies data into the buffer, see @a map
+     * @return the offset of the data in the buffer, -1 on failure
+     */
+    GLintptr write(const void *data, u32 size, u32 alignment);
+
+    /*!
+     * Fences the writes of the frame and moves to the next segment. Call after the draws are issued
+     */
+    void endFrame();
+
+    GLuint getBuffer() const { return m_Buffer; }
+
+    /*!
+     * @return times a write had to wait for the GPU to release a segment
+     */
+    u32 getStallCount() const { return m_Stalls; }
+
+private:
+    void bind() const;
+
+    void grow(u32 segmentSize);
+
+    GLenum m_Target;
+    GLuint m_Buffer = 0;
+    u32 m_SegmentSize;
+    // Bytes of the buffer storage, 0 until the first write creates it
+    u64 m_Capacity = 0;
+    u32 m_Segment = 0;
+    u32 m_Head = 0;
+    bool m_Waited = false;
+    std::array<GLsync, kFramesInFlight> m_Fences{};
+    u32 m_Stalls = 0;
+};
+
+#endif //_STREAM_BUFFER_H
@@ -0,0 +1,163 @@
+#include "TextLayout.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "Fonts.h"
+#include "Utils/Utility.h"
+
+/*!
+ * Cached runs kept at most. Past this the cache starts over, texts keep their runs
+ */
+static constexpr size_t kMaxCachedRuns = 256;
+
+size_t TextLayout::KeyHash::operator()(const Key &key) const {
+    size_t hash = std::hash<std::string>{}(key.Text);
+    const auto combine = [&hash](size_t value) {
+        hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    };
+    combine(static_cast<size_t>(key.Style.Align));
+    combine(std::hash<f32>{}(key.Style.MaxWidth));
+    combine(std::hash<f32>{}(key.Style.LineSpacing));
+    return hash;
+}
+
+std::shared_ptr<const TextRun> TextLayout::layout(std::string_view text, const TextStyle &style) {
+    Key key{std::string(text), style};
+    const auto it = m_Cache.find(key);
+    if (it != m_Cache.end() && it->second->Generation == m_Fonts.getGeneration()) {
+        return it->second;
+    }
+
+    // Stale runs are replaced rather than updated, texts still holding them see the old generation
+    auto run = std::make_shared<TextRun>();
+    shape(text, style, *run);
+
+    if (it != m_Cache.end()) {
+        it->second = run;
+    } else {
+        if (m_Cache.size() >= kMaxCachedRuns) {
+            m_Cache.clear();
+        }
+        m_Cache.emplace(std::move(key), run);
+    }
+    return run;
+}
+
+void TextLayout::shape(std::string_view text, const TextStyle &style, TextRun &run) {
+    m_Codepoints.clear();
+    size_t offset = 0;
+    while (offset < text.size()) {
+        m_Codepoints.push_back(Utility::decodeUtf8(text, offset));
+    }
+
+    // Split in lines [begin, end), breaking on new lines and on the last space before MaxWidth
+    struct Line {
+        size_t Begin;
+        size_t End;
+    };
+    std::vector<Line> lines;
+    size_t lineBegin = 0;
+    size_t lastSpace = std::string_view::npos;
+    f32 x = 0.0f;
+    for (size_t i = 0; i < m_Codepoints.size(); i++) {
+        const char32_t c = m_Codepoints[i];
+        if (c == '\n') {
+            lines.push_back(Line{lineBegin, i});
+            lineBegin = i + 1;
+            lastSpace = std::string_view::npos;
+            x = 0.0f;
+            continue;
+        }
+
+        const Character *ch = m_Fonts.getCharacter(c);
+        if (!ch) {
+            continue;
+        }
+        f32 advance = ch->Advance;
+        if (i > lineBegin) {
+            advance += m_Fonts.getKerning(m_Codepoints[i - 1], c);
+        }
+
+        if (style.MaxWidth > 0.0f && c != ' ' && x + advance > style.MaxWidth && lastSpace != std::string_view::npos) {
+            // Words longer than a line overflow it instead of being split
+            lines.push_back(Line{lineBegin, lastSpace});
+            lineBegin = lastSpace + 1;
+            lastSpace = std::string_view::npos;
+            x = measureRange(m_Codepoints, lineBegin, i + 1);
+            continue;
+        }
+
+        if (c == ' ') {
+            lastSpace = i;
+        }
+        x += advance;
+    }
+    lines.push_back(Line{lineBegin, m_Codepoints.size()});
+
+    // Trailing spaces don't count for alignment
+    std::vector<f32> widths(lines.size());
+    f32 maxWidth = 0.0f;
+    for (size_t line = 0; line < lines.size(); line++) {
+        size_t end = lines[line].End;
+        while (end > lines[line].Begin && m_Codepoints[end - 1] == ' ') {
+            end--;
+        }
+        widths[line] = measureRange(m_Codepoints, lines[line].Begin, end);
+        maxWidth = std::max(maxWidth, widths[line]);
+    }
+    const f32 boxWidth = style.MaxWidth > 0.0f ? std::max(style.MaxWidth, maxWidth) : maxWidth;
+
+    // Cap height of the first line sits at the origin
+    const Character *reference = m_Fonts.getCharacter('H');
+    const f32 baseline = reference ? reference->Bearing.y : 0.0f;
+    const f32 lineHeight = m_Fonts.getLineHeight() * style.LineSpacing;
+
+    run.Glyphs.clear();
+    for (size_t line = 0; line < lines.size(); line++) {
+        f32 penX = 0.0f;
+        if (style.Align == TextAlign::CENTER) {
+            penX = (boxWidth - widths[line]) * 0.5f;
+        } else if (style.Align == TextAlign::RIGHT) {
+            penX = boxWidth - widths[line];
+        }
+        const f32 penY = baseline + lineHeight * line;
+
+        for (size_t i = lines[line].Begin; i < lines[line].End; i++) {
+            const Character *ch = m_Fonts.getCharacter(m_Codepoints[i]);
+            if (!ch) {
+                continue;
+            }
+            if (i > lines[line].Begin) {
+                penX += m_Fonts.getKerning(m_Codepoints[i - 1], m_Codepoints[i]);
+            }
+
+            if (ch->Page != Fonts::kNoPage) {
+                run.Glyphs.push_back(TextGlyph{
+                        V2{penX + ch->Bearing.x, penY - ch->Bearing.y},
+                        ch->Size,
+                        ch->UVRect,
+                        ch->Page});
+            }
+            penX += ch->Advance;
+        }
+    }
+
+    run.Bounds = V2{boxWidth, lineHeight * lines.size()};
+    run.Generation = m_Fonts.getGeneration();
+}
+
+f32 TextLayout::measureRange(const std::vector<char32_t> &codepoints, size_t begin, size_t end) {
+    f32 width = 0.0f;
+    for (size_t i = begin; i < end; i++) {
+        const Character *ch = m_Fonts.getCharacter(codepoints[i]);
+        if (!ch) {
+            continue;
+        }
+        if (i > begin) {
+            width += m_Fonts.getKerning(codepoints[i - 1], codepoints[i]);
+        }
+        width += ch->Advance;
+    }
+    return width;
+}
@@ -0,0 +1,93 @@
+#ifndef _TEXT_LAYOUT_H
+#define _TEXT_LAYOUT_H
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Common.h"
+#include "Math/MathTypes.h"
+#include "ECS/Components.h"
+
+class Fonts;
+
+/*!
+ * Glyph quad of a laid out text, relative to the text origin and unscaled
+ */
+struct TextGlyph {
+    V2 Position;
+    V2 Size;
+    // Area of the glyph in the font atlas, offset (xy) and size (zw)
+    V4 UVRect;
+    // Font atlas page holding the glyph
+    u32 Page;
+};
+
+/*!
+ * Positioned glyphs of a string, the output of @a TextLayout
+ */
+struct TextRun {
+    std::vector<TextGlyph> Glyphs;
+    // Extent of the lines from the text origin, in unscaled text units
+    V2 Bounds{0.0f};
+    // Font generation the glyphs were placed with, the run is stale once it changes
+    u32 Generation = 0;
+};
+
+/*!
+ * Shapes strings into glyph runs: UTF-8 decoding, kerning, line breaking and alignment. Runs are
+ * cached by string and style, so texts showing the same string share one run and a string is only
+ * shaped again once the font evicts glyphs.
+ */
+class TextLayout {
+public:
+    explicit TextLayout(Fonts &fonts) : m_Fonts(fonts) {}
+
+    DISABLE_MOVE_AND_COPY(TextLayout)
+
+    /*!
+     * @param text UTF-8 string
+     * @param style layout parameters
+     * @return the shaped run, from the cache when possible
+     */
+    std::shared_ptr<const TextRun> layout(std::string_view text, const TextStyle &style);
+
+    /*!
+     * @return the extent of a string laid out with a style, in unscaled text units
+     */
+    V2 measure(std::string_view text, const TextStyle &style) { return layout(text, style)->Bounds; }
+
+    /*!
+     * Drops every cached run, runs still referenced by texts stay valid
+     */
+    void clear() { m_Cache.clear(); }
+
+    size_t getCachedCount() const { return m_Cache.size(); }
+
+private:
+    struct Key {
+        std::string Text;
+        TextStyle Style;
+
+        bool operator==(const Key &other) const { return Style == other.Style && Text == other.Text; }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key &key) const;
+    };
+
+    void shape(std::string_view text, const TextStyle &style, TextRun &run);
+
+    /*!
+     * @return the advance of codepoints [begin, end), kerning included
+     */
+    f32 measureRange(const std::vector<char32_t> &codepoints, size_t begin, size_t end);
+
+    Fonts &m_Fonts;
+    std::unordered_map<Key, std::shared_ptr<const TextRun>, KeyHash> m_Cache;
+    std::vector<char32_t> m_Codepoints;
+};
+
+#endif //_TEXT_LAYOUT_H
@@ -1,10 +1,21 @@
 #include <android/imagedecoder.h>
+#include <cstring>
 #include "TextureAsset.h"
 #include "Core/AndroidOut.h"
 #include "Utils/Utility.h"
+#include "GLState.h"
+#include "Memory/MemoryTracker.h"
 
 std::shared_ptr<TextureAsset>
 TextureAsset::loadAsset(AAssetManager *assetManager, const std::string &assetPath) {
+    u32 width = 0;
+    u32 height = 0;
+    const auto pixels = decodeAsset(assetManager, assetPath, width, height);
+    return create(width, height, pixels.data());
+}
+
+std::vector<u8>
+TextureAsset::decodeAsset(AAssetManager *assetManager, const std::string &assetPath, u32 &width, u32 &height) {
     // Get the image from asset manager
     auto pAndroidRobotPng = AAssetManager_open(
             assetManager,
@@ -24,23 +35,39 @@ TextureAsset::loadAsset(AAssetManager *assetManager, const std::string &assetPat
     pAndroidHeader = AImageDecoder_getHeaderInfo(pAndroidDecoder);
 
     // important metrics for sending to GL
-    auto width = AImageDecoderHeaderInfo_getWidth(pAndroidHeader);
-    auto height = AImageDecoderHeaderInfo_getHeight(pAndroidHeader);
+    width = AImageDecoderHeaderInfo_getWidth(pAndroidHeader);
+    height = AImageDecoderHeaderInfo_getHeight(pAndroidHeader);
     auto stride = AImageDecoder_getMinimumStride(pAndroidDecoder);
 
     // Get the bitmap data of the image
-    auto upAndroidImageData = std::make_unique<std::vector<uint8_t>>(height * stride);
+    std::vector<u8> imageData(height * stride);
     auto decodeResult = AImageDecoder_decodeImage(
             pAndroidDecoder,
-            upAndroidImageData->data(),
+            imageData.data(),
             stride,
-            upAndroidImageData->size());
+            imageData.size());
     assert(decodeResult == ANDROID_IMAGE_DECODER_SUCCESS);
 
+    // cleanup helpers
+    AImageDecoder_delete(pAndroidDecoder);
+    AAsset_close(pAndroidRobotPng);
+
+    // Drop the row padding so callers can address pixels directly
+    const size_t rowSize = static_cast<size_t>(width) * 4;
+    if (stride != rowSize) {
+        for (u32 y = 1; y < height; y++) {
+            std::memmove(imageData.data() + y * rowSize, imageData.data() + y * stride, rowSize);
+        }
+        imageData.resize(height * rowSize);
+    }
+    return imageData;
+}
+
+std::shared_ptr<TextureAsset> TextureAsset::create(u32 width, u32 height, const u8 *pixels, bool mipmaps) {
     // Get an opengl texture
     GLuint textureId;
     glGenTextures(1, &textureId);
-    glBindTexture(GL_TEXTURE_2D, textureId);
+    GLState::bindTexture(textureId);
 
     // Clamp to the edge, you'll get odd results alpha blending if you don't
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -59,24 +86,48 @@ TextureAsset::loadAsset(AAssetManager *assetManager, const std::string &assetPat
             0, // border (always 0)
             GL_RGBA, // format
             GL_UNSIGNED_BYTE, // type
-            upAndroidImageData->data() // Data to upload
+            pixels // Data to upload
     );
 
     // generate mip levels. Not really needed for 2D, but good to do
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    // cleanup helpers
-    AImageDecoder_delete(pAndroidDecoder);
-    AAsset_close(pAndroidRobotPng);
+    if (mipmaps) {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
 
+    // Create a shared pointer so it can be cleaned up easily/automatically
+    auto texture = std::shared_ptr<TextureAsset>(new TextureAsset(textureId, width, height));
+    texture->m_Opaque = pixels && isOpaque(pixels, width, height);
+    MemoryTracker::recordGpuAllocation(MemoryTag::Textures, texture->getGpuBytes());
+    return texture;
+}
 
+std::shared_ptr<TextureAsset>
+TextureAsset::createRegion(const std::shared_ptr<TextureAsset> &page, u32 width, u32 height, const V4 &uvRect,
+                           bool opaque) {
+    auto region = std::shared_ptr<TextureAsset>(new TextureAsset(page->getTextureID(), width, height));
+    region->m_UVRect = uvRect;
+    region->m_Page = page;
+    region->m_Opaque = opaque;
+    return region;
+}
 
-    // Create a shared pointer so it can be cleaned up easily/automatically
-    return std::shared_ptr<TextureAsset>(new TextureAsset(textureId, width, height));
+bool TextureAsset::isOpaque(const u8 *pixels, u32 width, u32 height) {
+    const size_t count = static_cast<size_t>(width) * height;
+    for (size_t i = 0; i < count; i++) {
+        if (pixels[i * 4 + 3] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
 }
 
 TextureAsset::~TextureAsset() {
+    // Regions share the texture of their page, the page cleans it up
+    if (m_Page) {
+        return;
+    }
     // return texture resources
-    glDeleteTextures(1, &m_TextureID);
+    MemoryTracker::recordGpuFree(MemoryTag::Textures, getGpuBytes());
+    GLState::deleteTexture(m_TextureID);
     m_TextureID = 0;
-}
\ No newline at end of file
+}
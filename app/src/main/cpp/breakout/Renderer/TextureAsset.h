@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "Common.h"
+#include "Math/MathTypes.h"
 
 class TextureAsset {
 public:
@@ -20,6 +21,42 @@ public:
     static std::shared_ptr<TextureAsset>
     loadAsset(AAssetManager *assetManager, const std::string &assetPath);
 
+    /*!
+     * Decodes an image from the assets/ directory without uploading it
+     * @param assetManager Asset manager to use
+     * @param assetPath The path to the asset
+     * @param width receives the width of the image
+     * @param height receives the height of the image
+     * @return tightly packed RGBA pixels
+     */
+    static std::vector<u8>
+    decodeAsset(AAssetManager *assetManager, const std::string &assetPath, u32 &width, u32 &height);
+
+    /*!
+     * Creates a texture from RGBA pixels
+     * @param pixels tightly packed RGBA pixels, null to leave the contents undefined
+     * @param mipmaps whether to build the mip chain now
+     */
+    static std::shared_ptr<TextureAsset> create(u32 width, u32 height, const u8 *pixels, bool mipmaps = true);
+
+    /*!
+     * Creates a view on part of another texture, used for atlas regions. The region keeps its page
+     * alive and never owns the GL texture.
+     * @param page texture holding the region
+     * @param width width of the region in pixels
+     * @param height height of the region in pixels
+     * @param uvRect offset (xy) and size (zw) of the region in UV space
+     */
+    static std::shared_ptr<TextureAsset>
+    createRegion(const std::shared_ptr<TextureAsset> &page, u32 width, u32 height, const V4 &uvRect,
+                 bool opaque);
+
+    /*!
+     * @param pixels tightly packed RGBA pixels
+     * @return true if every pixel has full alpha
+     */
+    static bool isOpaque(const u8 *pixels, u32 width, u32 height);
+
     ~TextureAsset();
 
     /*!
@@ -31,6 +68,26 @@ public:
 
     constexpr u32 getWidth() const { return m_Width; }
 
+    /*!
+     * @return true if the pixels of the asset are fully opaque, so it can be drawn without blending
+     */
+    bool isOpaque() const { return m_Opaque; }
+
+    /*!
+     * @return the area of the GL texture covered by this asset, offset (xy) and size (zw)
+     */
+    const V4 &getUVRect() const { return m_UVRect; }
+
+    /*!
+     * @return the atlas page holding the region, null if the asset owns its texture
+     */
+    const std::shared_ptr<TextureAsset> &getPage() const { return m_Page; }
+
+    /*!
+     * @return the video memory used by the texture, mip chain included
+     */
+    constexpr u64 getGpuBytes() const { return static_cast<u64>(m_Width) * m_Height * 4 * 4 / 3; }
+
 private:
     inline TextureAsset(GLuint textureId, u32 width, u32 height)
             : m_TextureID(textureId), m_Width(width), m_Height(height) {}
@@ -38,6 +95,9 @@ private:
     GLuint m_TextureID;
     u32 m_Width;
     u32 m_Height;
+    V4 m_UVRect = V4{0.0f, 0.0f, 1.0f, 1.0f};
+    bool m_Opaque = false;
+    std::shared_ptr<TextureAsset> m_Page;
 };
 
 #endif //ANDROIDGLINVESTIGATIONS_TEXTUREASSET_H
\ No newline at end of file
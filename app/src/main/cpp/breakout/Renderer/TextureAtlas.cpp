@@ -0,0 +1,78 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "GLState.h"
+
+TextureAtlas::TextureAtlas(u32 pageSize, u32 padding) : m_PageSize(pageSize), m_Padding(padding) {}
+
+std::shared_ptr<TextureAsset> TextureAtlas::add(const u8 *pixels, u32 width, u32 height) {
+    const u32 paddedWidth = width + m_Padding * 2;
+    const u32 paddedHeight = height + m_Padding * 2;
+    if (paddedWidth > m_PageSize || paddedHeight > m_PageSize) {
+        return nullptr;
+    }
+
+    Page *page = nullptr;
+    u32 x = 0;
+    u32 y = 0;
+    for (auto &candidate: m_Pages) {
+        if (candidate.Packer.pack(paddedWidth, paddedHeight, x, y)) {
+            page = &candidate;
+            break;
+        }
+    }
+    if (!page) {
+        page = &createPage();
+        page->Packer.pack(paddedWidth, paddedHeight, x, y);
+    }
+
+    // Copy the image in the middle of the padded block and extrude its edges into the border
+    m_Scratch.resize(static_cast<size_t>(paddedWidth) * paddedHeight * 4);
+    for (u32 row = 0; row < paddedHeight; row++) {
+        const u32 srcRow = std::min(row > m_Padding ? row - m_Padding : 0, height - 1);
+        const u8 *src = pixels + static_cast<size_t>(srcRow) * width * 4;
+        u8 *dst = m_Scratch.data() + static_cast<size_t>(row) * paddedWidth * 4;
+
+        for (u32 column = 0; column < m_Padding; column++) {
+            std::memcpy(dst + column * 4, src, 4);
+            std::memcpy(dst + (m_Padding + width + column) * 4, src + (width - 1) * 4, 4);
+        }
+        std::memcpy(dst + m_Padding * 4, src, static_cast<size_t>(width) * 4);
+    }
+
+    GLState::bindTexture(page->Texture->getTextureID());
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, paddedWidth, paddedHeight, GL_RGBA, GL_UNSIGNED_BYTE, m_Scratch.data());
+    page->Dirty = true;
+
+    const f32 size = static_cast<f32>(m_PageSize);
+    const V4 uvRect{(x + m_Padding) / size, (y + m_Padding) / size, width / size, height / size};
+    return TextureAsset::createRegion(page->Texture, width, height, uvRect,
+                                      TextureAsset::isOpaque(pixels, width, height));
+}
+
+void TextureAtlas::update() {
+    for (auto &page: m_Pages) {
+        if (page.Dirty) {
+            GLState::bindTexture(page.Texture->getTextureID());
+            glGenerateMipmap(GL_TEXTURE_2D);
+            page.Dirty = false;
+        }
+    }
+}
+
+void TextureAtlas::clear() {
+    m_Pages.clear();
+}
+
+TextureAtlas::Page &TextureAtlas::createPage() {
+    auto texture = TextureAsset::create(m_PageSize, m_PageSize, nullptr, false);
+
+    // Past this level a texel covers more than the padding and regions bleed into each other
+    GLState::bindTexture(texture->getTextureID());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(std::log2(std::max(m_Padding, 1u))));
+
+    return m_Pages.emplace_back(Page{std::move(texture), RectPacker(m_PageSize, m_PageSize), false});
+}
@@ -0,0 +1,62 @@
+#ifndef _TEXTURE_ATLAS_H
+#define _TEXTURE_ATLAS_H
+
+#include <memory>
+#include <vector>
+
+#include "Common.h"
+#include "RectPacker.h"
+#include "TextureAsset.h"
+
+/*!
+ * Packs sprite images into shared textures (pages) so sprites using different images can still be
+ * drawn in one batch. Every image is surrounded by a border repeating its edge pixels, which keeps
+ * filtering from sampling the neighbours.
+ */
+class TextureAtlas {
+public:
+    /*!
+     * @param pageSize width and height of each page in pixels
+     * @param padding border added around every image
+     */
+    explicit TextureAtlas(u32 pageSize = 1024, u32 padding = 4);
+
+    DISABLE_MOVE_AND_COPY(TextureAtlas)
+
+    /*!
+     * Copies an image into a page
+     * @param pixels tightly packed RGBA pixels
+     * @param width width of the image
+     * @param height height of the image
+     * @return the region holding the image, null if it doesn't fit in a page
+     */
+    std::shared_ptr<TextureAsset> add(const u8 *pixels, u32 width, u32 height);
+
+    /*!
+     * Rebuilds the mip chains of the pages modified since the last call. Call before drawing.
+     */
+    void update();
+
+    /*!
+     * Drops the pages, regions still in use keep theirs alive
+     */
+    void clear();
+
+    size_t getPageCount() const { return m_Pages.size(); }
+
+private:
+    struct Page {
+        std::shared_ptr<TextureAsset> Texture;
+        RectPacker Packer;
+        bool Dirty;
+    };
+
+    Page &createPage();
+
+    u32 m_PageSize;
+    u32 m_Padding;
+    std::vector<Page> m_Pages;
+    std::vector<u8> m_Scratch;
+};
+
+#endif //_TEXTURE_ATLAS_H
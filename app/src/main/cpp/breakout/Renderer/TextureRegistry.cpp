@@ -0,0 +1,156 @@
+#include "TextureRegistry.h"
+
+#include "Core/AndroidOut.h"
+
+// An atlas region can't give its space back to the page, unloading it frees nothing and loading
+// the path again would pack a second copy. Regions stay loaded and don't count against the budget
+static bool isEvictable(const TextureAsset &texture) {
+    return !texture.getPage();
+}
+
+static u64 getEvictableBytes(const TextureAsset &texture) {
+    return isEvictable(texture) ? texture.getGpuBytes() : 0;
+}
+
+TextureHandle::TextureHandle(const TextureHandle &other) : m_Registry(other.m_Registry), m_Id(other.m_Id) {
+    if (m_Registry) {
+        m_Registry->acquire(m_Id);
+    }
+}
+
+TextureHandle::TextureHandle(TextureHandle &&other) noexcept: m_Registry(other.m_Registry), m_Id(other.m_Id) {
+    other.m_Registry = nullptr;
+}
+
+TextureHandle &TextureHandle::operator=(const TextureHandle &other) {
+    if (this != &other) {
+        // Acquire first, the other handle may hold the last reference to the same texture
+        if (other.m_Registry) {
+            other.m_Registry->acquire(other.m_Id);
+        }
+        reset();
+        m_Registry = other.m_Registry;
+        m_Id = other.m_Id;
+    }
+    return *this;
+}
+
+TextureHandle &TextureHandle::operator=(TextureHandle &&other) noexcept {
+    if (this != &other) {
+        reset();
+        m_Registry = other.m_Registry;
+        m_Id = other.m_Id;
+        other.m_Registry = nullptr;
+    }
+    return *this;
+}
+
+TextureHandle::~TextureHandle() {
+    reset();
+}
+
+void TextureHandle::reset() {
+    if (m_Registry) {
+        m_Registry->release(m_Id);
+        m_Registry = nullptr;
+    }
+}
+
+TextureHandle TextureRegistry::load(const std::string &path) {
+    auto it = m_Ids.find(path);
+    if (it == m_Ids.end()) {
+        it = m_Ids.emplace(path, static_cast<u32>(m_Entries.size())).first;
+        m_Entries.push_back(Entry{path});
+    }
+
+    const u32 id = it->second;
+    Entry &entry = m_Entries[id];
+    if (!entry.Texture) {
+        entry.Texture = m_Loader(path);
+        if (!entry.Texture) {
+            aout << "Error: Couldn't load texture " << path << std::endl;
+            return {};
+        }
+        m_GpuBytes += entry.Texture->getGpuBytes();
+        // Loaded textures count as unused until acquired
+        m_UnusedBytes += getEvictableBytes(*entry.Texture);
+    }
+
+    acquire(id);
+    return {this, id};
+}
+
+const std::shared_ptr<TextureAsset> &TextureRegistry::get(u32 id) const {
+    static const std::shared_ptr<TextureAsset> s_Null;
+    return id < m_Entries.size() ? m_Entries[id].Texture : s_Null;
+}
+
+void TextureRegistry::setBudget(u64 bytes) {
+    m_Budget = bytes;
+    trim();
+}
+
+void TextureRegistry::evictUnused() {
+    for (auto &entry: m_Entries) {
+        if (entry.RefCount == 0 && entry.Texture && isEvictable(*entry.Texture)) {
+            unload(entry);
+        }
+    }
+}
+
+void TextureRegistry::clear() {
+    for (auto &entry: m_Entries) {
+        if (entry.Texture) {
+            unload(entry);
+        }
+    }
+}
+
+u32 TextureRegistry::getLoadedCount() const {
+    u32 count = 0;
+    for (const auto &entry: m_Entries) {
+        count += entry.Texture != nullptr;
+    }
+    return count;
+}
+
+void TextureRegistry::acquire(u32 id) {
+    Entry &entry = m_Entries[id];
+    if (entry.RefCount++ == 0 && entry.Texture) {
+        m_UnusedBytes -= getEvictableBytes(*entry.Texture);
+    }
+}
+
+void TextureRegistry::release(u32 id) {
+    Entry &entry = m_Entries[id];
+    assert(entry.RefCount > 0);
+    if (--entry.RefCount == 0 && entry.Texture) {
+        entry.LastReleased = ++m_ReleaseCounter;
+        m_UnusedBytes += getEvictableBytes(*entry.Texture);
+        trim();
+    }
+}
+
+void TextureRegistry::unload(Entry &entry) {
+    m_GpuBytes -= entry.Texture->getGpuBytes();
+    if (entry.RefCount == 0) {
+        m_UnusedBytes -= getEvictableBytes(*entry.Texture);
+    }
+    entry.Texture.reset();
+}
+
+void TextureRegistry::trim() {
+    while (m_UnusedBytes > m_Budget) {
+        Entry *oldest = nullptr;
+        for (auto &entry: m_Entries) {
+            if (entry.RefCount == 0 && entry.Texture && isEvictable(*entry.Texture)
+                && (!oldest || entry.LastReleased < oldest->LastReleased)) {
+                oldest = &entry;
+            }
+        }
+        if (!oldest) {
+            break;
+        }
+        unload(*oldest);
+    }
+}
@@ -0,0 +1,134 @@
+#ifndef _TEXTURE_REGISTRY_H
+#define _TEXTURE_REGISTRY_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Common.h"
+#include "TextureAsset.h"
+
+class TextureRegistry;
+
+/*!
+ * Counted reference to a texture of a @a TextureRegistry. The texture stays loaded while a handle
+ * to it exists. The id is what goes in SpriteComponent::Texture.
+ */
+class TextureHandle {
+public:
+    TextureHandle() = default;
+
+    TextureHandle(const TextureHandle &other);
+    TextureHandle(TextureHandle &&other) noexcept;
+    TextureHandle &operator=(const TextureHandle &other);
+    TextureHandle &operator=(TextureHandle &&other) noexcept;
+
+    ~TextureHandle();
+
+    /*!
+     * Drops the reference, the handle becomes invalid
+     */
+    void reset();
+
+    u32 getId() const { return m_Id; }
+
+    bool isValid() const { return m_Registry != nullptr; }
+
+    explicit operator bool() const { return isValid(); }
+
+private:
+    friend class TextureRegistry;
+
+    TextureHandle(TextureRegistry *registry, u32 id) : m_Registry(registry), m_Id(id) {}
+
+    TextureRegistry *m_Registry = nullptr;
+    u32 m_Id = 0;
+};
+
+/*!
+ * Textures keyed by asset path. Loading a path again returns the texture already loaded. Textures
+ * nobody references are kept around while the cache is under its GPU budget and evicted least
+ * recently released first once it goes over. A budget of 0 unloads them as soon as the last handle
+ * goes away. Ids stay valid for the lifetime of the registry, an evicted path gets its id back when
+ * loaded again. Atlas regions are never evicted nor counted against the budget, the atlas can't
+ * reclaim their space, so loading their path again always reuses the packed region.
+ */
+class TextureRegistry {
+public:
+    //! Creates the texture of a path, decoding and uploading it
+    using Loader = std::function<std::shared_ptr<TextureAsset>(const std::string &)>;
+
+    explicit TextureRegistry(Loader loader) : m_Loader(std::move(loader)) {}
+
+    DISABLE_MOVE_AND_COPY(TextureRegistry)
+
+    /*!
+     * @param path asset path of the image
+     * @return a handle to the texture, invalid if it couldn't be loaded
+     */
+    TextureHandle load(const std::string &path);
+
+    /*!
+     * @param id id of a handle
+     * @return the texture, null if the id is unknown or evicted
+     */
+    const std::shared_ptr<TextureAsset> &get(u32 id) const;
+
+    /*!
+     * Sets how much GPU memory unused textures may keep, evicting them if needed
+     */
+    void setBudget(u64 bytes);
+
+    /*!
+     * Unloads every unused texture that isn't an atlas region
+     */
+    void evictUnused();
+
+    /*!
+     * Drops every texture, handles still alive keep their id but resolve to null
+     */
+    void clear();
+
+    /*!
+     * @return GPU memory of the loaded textures. Atlas regions count their own area, not the page
+     */
+    u64 getGpuBytes() const { return m_GpuBytes; }
+
+    u64 getBudget() const { return m_Budget; }
+
+    u32 getLoadedCount() const;
+
+private:
+    friend class TextureHandle;
+
+    struct Entry {
+        std::string Path;
+        std::shared_ptr<TextureAsset> Texture;
+        u32 RefCount = 0;
+        // Release order, used to evict the oldest unused texture first
+        u64 LastReleased = 0;
+    };
+
+    void acquire(u32 id);
+
+    void release(u32 id);
+
+    void unload(Entry &entry);
+
+    /*!
+     * Evicts unused textures until they fit in the budget
+     */
+    void trim();
+
+    Loader m_Loader;
+    std::vector<Entry> m_Entries;
+    std::unordered_map<std::string, u32> m_Ids;
+    u64 m_Budget = 0;
+    u64 m_GpuBytes = 0;
+    u64 m_UnusedBytes = 0;
+    u64 m_ReleaseCounter = 0;
+};
+
+#endif //_TEXTURE_REGISTRY_H
@@ -0,0 +1,107 @@
+
+#include <array>
+#include <chrono>
+#include "Core/AndroidOut.h"
+#include "Latency.h"
+
+
+namespace Latency
+{
+	namespace
+	{
+		// Histogram resolution, every bucket covers 0.1ms up to 100ms
+		constexpr u32 c_BucketsPerMs = 10;
+		constexpr u32 c_BucketCount = 100 * c_BucketsPerMs;
+
+		// Inputs that can be tagged on a single frame, the rest are dropped
+		constexpr u32 c_MaxPendingInputs = 64;
+
+		std::array<i64, c_MaxPendingInputs> g_PendingInputs{};
+		u32 g_PendingCount = 0;
+
+		std::array<u32, c_BucketCount + 1> g_Histogram{}; // Last bucket holds overflows
+		u32 g_Samples = 0;
+		i64 g_MaxLatency = 0;
+
+		i64 now()
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		f32 percentile(f32 fraction)
+		{
+			const u32 target = static_cast<u32>(fraction * static_cast<f32>(g_Samples - 1)) + 1;
+			u32 accumulated = 0;
+			for (u32 i = 0; i < c_BucketCount; i++)
+			{
+				accumulated += g_Histogram[i];
+				if (accumulated >= target)
+				{
+					return static_cast<f32>(i + 1) / c_BucketsPerMs;
+				}
+			}
+			return static_cast<f32>(g_MaxLatency) / 1000000.0f;
+		}
+	}
+
+	void onInputReceived()
+	{
+		if (g_PendingCount < c_MaxPendingInputs)
+		{
+			g_PendingInputs[g_PendingCount++] = now();
+		}
+	}
+
+	void onFramePresented()
+	{
+		if (g_PendingCount == 0)
+		{
+			return;
+		}
+
+		const i64 presentTime = now();
+		for (u32 i = 0; i < g_PendingCount; i++)
+		{
+			const i64 latency = presentTime - g_PendingInputs[i];
+			const u32 bucket = static_cast<u32>(latency * c_BucketsPerMs / 1000000);
+
+			g_Histogram[bucket < c_BucketCount ? bucket : c_BucketCount]++;
+			g_MaxLatency = latency > g_MaxLatency ? latency : g_MaxLatency;
+			g_Samples++;
+		}
+		g_PendingCount = 0;
+	}
+
+	Percentiles getPercentiles()
+	{
+		Percentiles result;
+		if (g_Samples == 0)
+		{
+			return result;
+		}
+
+		result.P50 = percentile(0.50f);
+		result.P95 = percentile(0.95f);
+		result.P99 = percentile(0.99f);
+		result.Max = static_cast<f32>(g_MaxLatency) / 1000000.0f;
+		result.Samples = g_Samples;
+		return result;
+	}
+
+	void reset()
+	{
+		g_Histogram.fill(0);
+		g_Samples = 0;
+		g_MaxLatency = 0;
+		g_PendingCount = 0;
+	}
+
+	void dump()
+	{
+		const Percentiles percentiles = getPercentiles();
+		aout << "Input latency (" << percentiles.Samples << " events): p50 " << percentiles.P50
+		     << "ms, p95 " << percentiles.P95 << "ms, p99 " << percentiles.P99
+		     << "ms, max " << percentiles.Max << "ms" << std::endl;
+	}
+}
@@ -0,0 +1,64 @@
+/*
+MIT License
+
+Copyright (c) 2023 Victor Falcon Zaro
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef _LATENCY_H_
+#define _LATENCY_H_
+
+#include <Common.h>
+
+//! Input-to-display latency tracking
+/*
+*	Every input event is tagged with the time it was pulled from the input buffer.
+*	The tags travel with the frame being built and are resolved once that frame
+*	has been handed to eglSwapBuffers, feeding a fixed size histogram.
+*/
+namespace Latency
+{
+	//! Latency percentiles, in milliseconds
+	struct Percentiles
+	{
+		f32 P50 = 0.0f;
+		f32 P95 = 0.0f;
+		f32 P99 = 0.0f;
+		f32 Max = 0.0f;
+		u32 Samples = 0;
+	};
+
+	//! Tags the frame being built with an input event that just arrived
+	void onInputReceived();
+
+	//! Resolves the tags of the current frame, call after the swap
+	void onFramePresented();
+
+	//! @return The latency percentiles recorded so far
+	NODISCARD Percentiles getPercentiles();
+
+	//! Clears the recorded histogram
+	void reset();
+
+	//! Logs the recorded percentiles
+	void dump();
+}
+
+#endif
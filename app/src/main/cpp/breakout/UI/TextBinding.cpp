@@ -0,0 +1,30 @@
+#include "TextBinding.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+NumericTextBinding::NumericTextBinding(Entity entity, std::string_view prefix)
+		: m_Entity(entity)
+{
+	// Leave room for the longest 64 bit value
+	m_PrefixLength = std::min(prefix.size(), c_BufferSize - 20);
+	std::memcpy(m_Buffer.data(), prefix.data(), m_PrefixLength);
+}
+
+void NumericTextBinding::set(i64 value)
+{
+	if (!m_Entity || (m_HasValue && value == m_Value))
+	{
+		return;
+	}
+
+	char *begin = m_Buffer.data() + m_PrefixLength;
+	const auto result = std::to_chars(begin, m_Buffer.data() + m_Buffer.size(), value);
+
+	auto &text = m_Entity.getComponent<TextComponent>();
+	text.setText(std::string_view(m_Buffer.data(), result.ptr - m_Buffer.data()));
+
+	m_Value = value;
+	m_HasValue = true;
+}
@@ -0,0 +1,66 @@
+/*
+MIT License
+
+Copyright (c) 2023 Victor Falcon Zaro
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <array>
+#include <string_view>
+
+#include <ECS/Entity.h>
+
+//! Binds a numeric value to the text of an entity
+/*
+*	The text is formatted as the prefix followed by the value, into a fixed
+*	buffer without touching the heap. It is only rebuilt, and the text layout
+*	invalidated, when the value actually changes.
+*/
+class NumericTextBinding
+{
+public:
+	//! Default constructor, creates an unbound binding
+	NumericTextBinding() = default;
+
+	//! Constructor
+	//! @param entity Entity holding the TextComponent to update
+	//! @param prefix Text placed before the value
+	NumericTextBinding(Entity entity, std::string_view prefix);
+
+	DEFAULT_MOVE_AND_COPY(NumericTextBinding)
+
+	//! Updates the bound value
+	//! @param value New value
+	void set(i64 value);
+
+	//! @return If the binding is attached to an entity
+	NODISCARD bool isBound() const { return m_Entity; }
+
+private:
+	static constexpr size_t c_BufferSize = 64;
+
+	Entity m_Entity{}; /**< Entity holding the text */
+	std::array<char, c_BufferSize> m_Buffer{}; /**< Prefix followed by the formatted value */
+	size_t m_PrefixLength = 0; /**< Characters of the prefix in the buffer */
+	i64 m_Value = 0; /**< Last value written */
+	bool m_HasValue = false; /**< If a value has been written yet */
+};
@@ -84,4 +84,51 @@ float *Utility::buildIdentityMatrix(float *outMatrix) {
     outMatrix[15] = 1.f;
 
     return outMatrix;
-}
\ No newline at end of file
+}
+
+char32_t Utility::decodeUtf8(std::string_view text, size_t &offset) {
+    constexpr char32_t replacement = 0xFFFD;
+
+    const auto lead = static_cast<unsigned char>(text[offset++]);
+    if (lead < 0x80) {
+        return lead;
+    }
+
+    size_t length;
+    char32_t codepoint;
+    char32_t minimum;
+    if ((lead & 0xE0) == 0xC0) {
+        length = 1;
+        codepoint = lead & 0x1F;
+        minimum = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+        length = 2;
+        codepoint = lead & 0x0F;
+        minimum = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+        length = 3;
+        codepoint = lead & 0x07;
+        minimum = 0x10000;
+    } else {
+        return replacement;
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        if (offset >= text.size()) {
+            return replacement;
+        }
+        const auto continuation = static_cast<unsigned char>(text[offset]);
+        if ((continuation & 0xC0) != 0x80) {
+            // Leave the byte for the next call, it may start a valid sequence
+            return replacement;
+        }
+        codepoint = (codepoint << 6) | (continuation & 0x3F);
+        offset++;
+    }
+
+    // Overlong encodings, surrogates and values past the unicode range
+    if (codepoint < minimum || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+        return replacement;
+    }
+    return codepoint;
+}
@@ -2,6 +2,7 @@
 #define ANDROIDGLINVESTIGATIONS_UTILITY_H
 
 #include <cassert>
+#include <string_view>
 
 class Utility {
 public:
@@ -29,6 +30,15 @@ public:
             float far);
 
     static float *buildIdentityMatrix(float *outMatrix);
+
+    /**
+     * Decodes the next codepoint of a UTF-8 string
+     *
+     * @param text the string to decode
+     * @param offset byte offset of the codepoint, advanced past it
+     * @return the codepoint, U+FFFD for malformed or truncated sequences
+     */
+    static char32_t decodeUtf8(std::string_view text, size_t &offset);
 };
 
 #endif //ANDROIDGLINVESTIGATIONS_UTILITY_H
\ No newline at end of file